@@ -9,15 +9,21 @@
 #include "blah_ease.h"
 #include "blah_filesystem.h"
 #include "blah_font.h"
+#include "blah_framearena.h"
 #include "blah_graphics.h"
 #include "blah_image.h"
 #include "blah_input.h"
+#include "blah_hashmap.h"
+#include "blah_memory.h"
 #include "blah_packer.h"
+#include "blah_slotmap.h"
 #include "blah_spatial.h"
 #include "blah_spritefont.h"
 #include "blah_stackvector.h"
 #include "blah_string.h"
+#include "blah_stringid.h"
 #include "blah_stream.h"
 #include "blah_subtexture.h"
+#include "blah_textlayout.h"
 #include "blah_time.h"
 #include "blah_vector.h"
\ No newline at end of file
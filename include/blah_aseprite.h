@@ -9,7 +9,6 @@ namespace Blah
 {
 	// A simple Aseprite file parser.
 	// Note:
-	//  - This implementation does not support Aseprite blendmodes.
 	//  - This implementation does not yet support Tilesets.
 	class Aseprite
 	{
@@ -61,6 +60,43 @@ namespace Blah
 			Group = 1
 		};
 
+		enum class BlendModes
+		{
+			Normal = 0,
+			Multiply = 1,
+			Screen = 2,
+			Overlay = 3,
+			Darken = 4,
+			Lighten = 5,
+			ColorDodge = 6,
+			ColorBurn = 7,
+			HardLight = 8,
+			SoftLight = 9,
+			Difference = 10,
+			Exclusion = 11,
+			Hue = 12,
+			Saturation = 13,
+			Color = 14,
+			Luminosity = 15,
+			Addition = 16,
+			Subtract = 17,
+			Divide = 18
+		};
+
+		enum class LoadModes
+		{
+			// Decodes every Cel and composites every Frame image while loading
+			Full,
+
+			// Decodes every Cel, but only composites a Frame image the first
+			// time it is requested through `get_frame_image`
+			Lazy,
+
+			// Only parses the Layers, Tags, Slices, Palette and User Data.
+			// No pixel data is decoded.
+			MetadataOnly
+		};
+
 		struct UserData
 		{
 			String text;
@@ -120,6 +156,7 @@ namespace Blah
 		};
 
 		Modes mode = Modes::RGBA;
+		LoadModes load_mode = LoadModes::Full;
 		int width = 0;
 		int height = 0;
 		Vector<Layer> layers;
@@ -128,20 +165,51 @@ namespace Blah
 		Vector<Slice> slices;
 		Vector<Color> palette;
 
+		// When loaded with LoadModes::Lazy, the maximum number of composited
+		// Frame images to keep in memory. The least recently requested Frame
+		// image is disposed when this is exceeded. 0 means there is no limit.
+		int max_cached_frames = 0;
+
+		// `thread_count` is the number of threads used to decode Cels and composite Frames.
+		// 1 does everything on the calling thread, and 0 uses every available hardware thread.
 		Aseprite() = default;
-		Aseprite(const FilePath& path);
-		Aseprite(Stream& stream);
+		Aseprite(const FilePath& path, LoadModes load_mode = LoadModes::Full, int thread_count = 1);
+		Aseprite(Stream& stream, LoadModes load_mode = LoadModes::Full, int thread_count = 1);
+
+		// Gets the composited image of the given Frame.
+		// In LoadModes::Lazy the Frame is composited the first time it is requested,
+		// and the returned reference may be disposed by a later call if `max_cached_frames` is set.
+		// In LoadModes::MetadataOnly this returns an empty Image.
+		const Image& get_frame_image(int frame);
 
 	private:
+		// Cel pixel data that is decoded after the file has been read
+		struct DeferredCel
+		{
+			int frame = 0;
+			int cel = 0;
+
+			// the cel's compressed data, which points into the Stream if its contents are in memory,
+			// and otherwise into `buffer`
+			const u8* compressed = nullptr;
+			size_t compressed_size = 0;
+			Vector<u8> buffer;
+		};
+
 		UserData* m_last_userdata = nullptr;
+		Vector<int> m_cached_frames;
+		Vector<DeferredCel> m_deferred_cels;
+		bool m_deferred = false;
 
-		void parse(Stream& stream);
+		void parse(Stream& stream, int thread_count);
 		void parse_layer(Stream& stream, int frame);
 		void parse_cel(Stream& stream, int frame, size_t maxPosition);
 		void parse_palette(Stream& stream, int frame);
 		void parse_user_data(Stream& stream, int frame);
 		void parse_tag(Stream& stream, int frame);
 		void parse_slice(Stream& stream, int frame);
+		bool decode_cel(Cel* cel, const u8* compressed, size_t compressed_size) const;
+		void render_frame(Frame* frame);
 		void render_cel(Cel* cel, Frame* frame);
 	};
 }
\ No newline at end of file
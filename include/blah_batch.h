@@ -2,6 +2,7 @@
 #include <blah_vector.h>
 #include <blah_string.h>
 #include <blah_spritefont.h>
+#include <blah_textlayout.h>
 #include <blah_subtexture.h>
 #include <blah_spatial.h>
 #include <blah_color.h>
@@ -25,6 +26,29 @@ namespace Blah
 			Wash
 		};
 
+		// Style used when drawing text with signed distance field SpriteFonts.
+		// Widths and offsets are in pixels at the SpriteFont's size, and are limited by its SDF spread.
+		struct SdfStyle
+		{
+			// width of the outline around each glyph
+			float outline_width = 0;
+
+			// color of the outline
+			Color outline_color = Color::transparent;
+
+			// offset of the drop shadow
+			Vec2f shadow_offset;
+
+			// how far the edge of the drop shadow is blurred
+			float shadow_softness = 0;
+
+			// color of the drop shadow
+			Color shadow_color = Color::transparent;
+
+			bool operator==(const SdfStyle& rhs) const;
+			bool operator!=(const SdfStyle& rhs) const { return !(*this == rhs); }
+		};
+
 		// The name of the default uniforms to set
 		String texture_uniform = "u_texture";
 		String sampler_uniform = "u_texture_sampler";
@@ -34,6 +58,12 @@ namespace Blah
 		// This is useful for drawing Pixel Art stuff
 		bool integerize = false;
 
+		// Skips drawing text glyphs and lines that are outside of the current scissor.
+		// The scissor is compared against the Batch's own matrix only, so this should
+		// only be enabled when rendering with `render(target)`. Rendering with a custom
+		// matrix (ex. a camera) would cull text that is actually visible.
+		bool cull_text = false;
+
 		// Default Sampler, set on clear
 		TextureSampler default_sampler;
 
@@ -95,6 +125,15 @@ namespace Blah
 		// Gets the current ColorMode from the top of the stack
 		ColorMode peek_color_mode() const;
 
+		// Pushes a style used when drawing signed distance field SpriteFonts
+		void push_sdf_style(const SdfStyle& style);
+
+		// Pops a signed distance field style
+		SdfStyle pop_sdf_style();
+
+		// Gets the current signed distance field style from the top of the stack
+		SdfStyle peek_sdf_style() const;
+
 		// Sets the current texture used for drawing. Note that certain functions will override
 		// this (ex the `str` and `tex` methods)
 		void set_texture(const TextureRef& texture);
@@ -161,6 +200,8 @@ namespace Blah
 
 		void str(const SpriteFont& font, const String& text, const Vec2f& pos, Color color);
 		void str(const SpriteFont& font, const String& text, const Vec2f& pos, const Vec2f& justify, float size, Color color);
+		void str(const TextLayout& layout, const Vec2f& pos, Color color);
+		void str(const TextLayout& layout, const Mat3x2f& matrix, Color color);
 
 	private:
 
@@ -197,6 +238,13 @@ namespace Blah
 				scissor(0, 0, -1, -1) {}
 		};
 
+		struct SdfMaterial
+		{
+			SdfStyle style;
+			int spread;
+			MaterialRef material;
+		};
+
 		MaterialRef m_default_material;
 		MeshRef m_mesh;
 		Mat3x2f m_matrix = Mat3x2f::identity;
@@ -214,7 +262,17 @@ namespace Blah
 		Vector<int> m_layer_stack;
 		Vector<DrawBatch> m_batches;
 		int m_batch_insert = 0;
+		SdfStyle m_sdf_style;
+		Vector<SdfStyle> m_sdf_style_stack;
+		Vector<SdfMaterial> m_sdf_materials;
+		int m_sdf_materials_used = 0;
+		SpriteFont::Measurement m_str_measurement;
+		StringId m_texture_uniform;
+		StringId m_sampler_uniform;
+		StringId m_matrix_uniform;
 
 		void render_single_batch(DrawCall& pass, const DrawBatch& b, const Mat4x4f& matrix);
+		MaterialRef get_sdf_material(int spread);
+		bool get_text_cull_bounds(Rectf* bounds) const;
 	};
 }
\ No newline at end of file
@@ -23,6 +23,39 @@ namespace Blah
 		Create,
 	};
 
+	// Priority of an asynchronous File request.
+	// Higher priority requests are started first, and requests with the same priority are started in order.
+	// Priority never reorders requests for the same file.
+	enum class FilePriority
+	{
+		Low,
+		Normal,
+		High,
+	};
+
+	// The result of File::read_async
+	struct FileReadResult
+	{
+		// path of the File that was read
+		FilePath path;
+
+		// whether the entire File was read
+		bool success = false;
+
+		// contents of the File, which can be moved out by the callback
+		Vector<u8> data;
+	};
+
+	// The result of File::write_async
+	struct FileWriteResult
+	{
+		// path of the File that was written
+		FilePath path;
+
+		// whether all of the data was written
+		bool success = false;
+	};
+
 	class File
 	{
 	protected:
@@ -39,6 +72,24 @@ namespace Blah
 		// deletes the given file
 		static bool destroy(const FilePath& path);
 
+		// Reads the entire file on a background thread.
+		// `on_complete` is called on the main thread, during the App update after the read finishes.
+		// Requests for the same file are never run at the same time, and are always run in the order they
+		// were made regardless of priority. ex. a High priority read waits for an earlier Normal priority write.
+		// If threading is disabled (BLAH_NO_THREADING) the file is read immediately, but `on_complete` is still deferred.
+		static void read_async(const FilePath& path, const Func<void, FileReadResult&>& on_complete, FilePriority priority = FilePriority::Normal);
+
+		// Creates or overwrites the file with the data on a background thread.
+		// `on_complete` is called on the main thread, during the App update after the write finishes.
+		// Pending writes are always finished before the App shuts down.
+		static void write_async(const FilePath& path, Vector<u8>&& data, const Func<void, const FileWriteResult&>& on_complete = nullptr, FilePriority priority = FilePriority::Normal);
+
+		// Number of async requests that haven't had their `on_complete` called yet
+		static int pending_async();
+
+		// Blocks until every async request has finished, and calls their `on_complete`
+		static void wait_async();
+
 		// Default Destructor
 		virtual ~File() = default;
 
@@ -11,6 +11,52 @@ namespace Blah
 	class Font;
 	using FontRef = Ref<Font>;
 
+	class FontData;
+	using FontDataRef = Ref<FontData>;
+
+	// Immutable font file data, which can be shared between any number of Fonts.
+	// The data is either owned, memory-mapped from a file, or borrowed from a caller-owned buffer.
+	// Use FontData::create() to instantiate a FontDataRef.
+	class FontData
+	{
+	private:
+		FontData() = default;
+
+	public:
+		FontData(const FontData&) = delete;
+		FontData& operator=(const FontData&) = delete;
+		~FontData();
+
+		// Memory-maps the font file at the given path.
+		// If the file can't be mapped, it's read into memory instead.
+		static FontDataRef create(const FilePath& path);
+
+		// reads the font data from the Stream
+		static FontDataRef create(Stream& stream);
+
+		// Borrows the given buffer without copying it.
+		// The buffer must stay alive and unchanged for as long as the FontData, or any Font created from it, exists.
+		static FontDataRef create(const u8* data, size_t length);
+
+		// pointer to the font file data
+		const u8* data() const;
+
+		// length of the font file data, in bytes
+		size_t length() const;
+
+		// whether the data is memory-mapped from a file
+		bool is_mapped() const;
+
+		// number of fonts in the data (font collections, like .ttc files, can have more than one)
+		int font_count() const;
+
+	private:
+		Vector<u8> m_buffer;
+		const u8* m_data = nullptr;
+		size_t m_length = 0;
+		bool m_mapped = false;
+	};
+
 	// Loads fonts from file and can blit individual characters to images.
 	// Use Font::create() to instantiate a FontRef.
 	class Font
@@ -51,12 +97,31 @@ namespace Blah
 			bool has_glyph = false;
 		};
 
-		// creates a new font from the given file path
+		// Kerning between two glyphs
+		struct KerningPair
+		{
+			int glyph1 = 0;
+			int glyph2 = 0;
+			float value = 0;
+		};
+
+		// creates a new font from the given file path. the file is memory-mapped if possible.
 		static FontRef create(const FilePath& path);
 
 		// creates a new font from the Stream
 		static FontRef create(Stream& stream);
 
+		// Creates a new font from the given buffer, without copying it.
+		// The buffer must stay alive and unchanged for as long as the Font exists.
+		static FontRef create(const u8* data, size_t length);
+
+		// Creates a new font from shared font data.
+		// `index` selects the font to use in font collections (see `FontData::font_count`).
+		static FontRef create(const FontDataRef& data, int index = 0);
+
+		// returns the font data the font was created from
+		const FontDataRef& data() const;
+
 		// returns the font family name
 		const String& family_name() const;
 
@@ -78,6 +143,10 @@ namespace Blah
 		// the height of the line, including line gap
 		int line_height() const;
 
+		// the bounding box that would contain every glyph in the font, in unscaled font units.
+		// note that font units are y-up, so the top of the glyph is at bounds.y + bounds.h.
+		Recti bounding_box() const;
+
 		// gets the glyph index for the given codepoint
 		int get_glyph(Codepoint codepoint) const;
 
@@ -87,6 +156,14 @@ namespace Blah
 		// gets the font kerning between 2 glyphs
 		float get_kerning(int glyph1, int glyph2, float scale) const;
 
+		// Gets every kerning pair in the font's kern table, at the provided scale.
+		// Returns false if the kerning pairs can't be listed (ex. the font uses a GPOS table),
+		// in which case `get_kerning` must be used on each pair instead.
+		bool get_kerning_pairs(Vector<KerningPair>& pairs, float scale) const;
+
+		// whether the glyph can be the first glyph in a kerning pair
+		bool has_kerning(int glyph) const;
+
 		// gets character data for the given glyph, at the provided scale
 		Character get_character(int glyph, float scale) const;
 
@@ -99,9 +176,20 @@ namespace Blah
 		// If the character doesn't exist, this will return an empty image.
 		Image get_image(const Character& ch) const;
 
+		// Gets character data for the given glyph as a signed distance field, at the provided scale.
+		// `spread` is how many pixels the distance field extends past the edges of the glyph.
+		Character get_sdf_character(int glyph, float scale, int spread) const;
+
+		// Blits a signed distance field of the character to the provided pixel array.
+		// The distance is stored in the alpha channel: 128 is the edge of the glyph, and
+		// the value changes by 128 / spread for every pixel away from the edge.
+		// The character must be from `get_sdf_character` with the same spread.
+		// The pixel array must be at least ch.width * ch.height in size!
+		bool get_sdf_image(const Character& ch, int spread, Color* pixels) const;
+
 	private:
 		Ref<void> m_font;
-		Vector<u8> m_buffer;
+		FontDataRef m_data;
 		String m_family_name;
 		String m_style_name;
 		int m_ascent = 0;
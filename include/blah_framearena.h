@@ -0,0 +1,422 @@
+#pragma once
+#include <blah_common.h>
+#include <blah_memory.h>
+#include <type_traits> // for trivially copyable fast paths
+#include <string.h>    // for memcpy
+
+namespace Blah
+{
+	// A linear allocator for temporary data that only needs to live until the end of the frame.
+	// Allocating is a pointer bump, and everything is released at once when the arena is reset,
+	// which the App does at the end of every frame (after rendering).
+	// Destructors are never run, and the arena is not thread-safe, so it should only be used from the main thread.
+	namespace FrameArena
+	{
+		// the default size of each block of memory the arena allocates
+		constexpr size_t default_block_size = 1024 * 1024;
+
+		// FrameArena memory statistics
+		struct Stats
+		{
+			// bytes allocated this frame
+			size_t bytes = 0;
+
+			// allocations made this frame
+			size_t allocations = 0;
+
+			// bytes allocated last frame
+			size_t last_frame_bytes = 0;
+
+			// the most bytes that have been allocated in a single frame
+			size_t peak_bytes = 0;
+
+			// bytes reserved by the arena's blocks
+			size_t capacity = 0;
+
+			// number of blocks the arena currently has
+			int blocks = 0;
+
+			// how many times the arena has been reset
+			u64 frame = 0;
+		};
+
+		// Allocates uninitialized memory that is valid until the arena is reset
+		void* alloc(size_t size, size_t alignment = Memory::default_alignment);
+
+		// Allocates and value-initializes `count` elements that are valid until the arena is reset.
+		// Destructors are never run, so only trivially destructible types are allowed.
+		template<class T>
+		T* alloc(i64 count = 1);
+
+		// Tries to grow the most recent allocation in place, returning true on success
+		bool extend(void* ptr, size_t size, size_t new_size);
+
+		// Formats a string into the arena, which is valid until the arena is reset
+		const char* format(const char* fmt, ...);
+
+		// Releases everything allocated this frame.
+		// If the frame needed more than one block, they're merged so the next frame fits in one.
+		void reset();
+
+		// Frees all of the arena's memory
+		void dispose();
+
+		// Sets the size of blocks the arena allocates
+		void set_block_size(size_t size);
+
+		// Gets the arena's memory statistics
+		Stats stats();
+	}
+
+	// A Vector-like container whose memory comes from the FrameArena.
+	// It must not be used after the frame it was created on has ended.
+	// Elements are destroyed when the FrameVector is, but its memory is only released with the arena.
+	template<class T>
+	class FrameVector
+	{
+	private:
+		T* m_buffer = nullptr;
+		i64 m_count = 0;
+		i64 m_capacity = 0;
+		u64 m_frame = 0;
+
+	public:
+
+		FrameVector() = default;
+		FrameVector(i64 capacity);
+		FrameVector(const FrameVector&) = delete;
+		FrameVector(FrameVector&& src) noexcept;
+		~FrameVector();
+
+		FrameVector& operator=(const FrameVector&) = delete;
+		FrameVector& operator=(FrameVector&& src) noexcept;
+
+		void clear();
+
+		i64 size() const;
+		i64 capacity() const;
+
+		void reserve(i64 new_capacity);
+		void resize(i64 new_count);
+		T* expand(i64 amount = 1);
+
+		void push_back(const T& item);
+		void push_back(T&& item);
+		template<class ...Args>
+		void emplace_back(Args&&...args);
+
+		T& operator[](i64 index);
+		const T& operator[](i64 index) const;
+
+		T* data();
+		const T* data() const;
+		T* begin();
+		const T* begin() const;
+		T* end();
+		const T* end() const;
+		T& front();
+		const T& front() const;
+		T& back();
+		const T& back() const;
+
+		T pop();
+	};
+
+	template<class T>
+	inline T* FrameArena::alloc(i64 count)
+	{
+		static_assert(std::is_trivially_destructible<T>(), "FrameArena never runs destructors");
+
+		if (count <= 0 || (size_t)count > SIZE_MAX / sizeof(T))
+			return nullptr;
+
+		T* result = (T*)alloc(sizeof(T) * (size_t)count, alignof(T));
+		if (result != nullptr)
+		{
+			for (i64 i = 0; i < count; i++)
+				new (result + i) T();
+		}
+
+		return result;
+	}
+
+	template<class T>
+	inline FrameVector<T>::FrameVector(i64 capacity)
+	{
+		reserve(capacity);
+	}
+
+	template<class T>
+	inline FrameVector<T>::FrameVector(FrameVector&& src) noexcept
+	{
+		m_buffer = src.m_buffer;
+		m_count = src.m_count;
+		m_capacity = src.m_capacity;
+		m_frame = src.m_frame;
+		src.m_buffer = nullptr;
+		src.m_count = src.m_capacity = 0;
+	}
+
+	template<class T>
+	inline FrameVector<T>::~FrameVector()
+	{
+		clear();
+	}
+
+	template<class T>
+	inline FrameVector<T>& FrameVector<T>::operator=(FrameVector&& src) noexcept
+	{
+		clear();
+		m_buffer = src.m_buffer;
+		m_count = src.m_count;
+		m_capacity = src.m_capacity;
+		m_frame = src.m_frame;
+		src.m_buffer = nullptr;
+		src.m_count = src.m_capacity = 0;
+		return *this;
+	}
+
+	template<class T>
+	inline void FrameVector<T>::clear()
+	{
+		BLAH_ASSERT(m_count == 0 || m_frame == FrameArena::stats().frame, "FrameVector was used after its frame ended");
+
+		if constexpr (!std::is_trivially_destructible<T>())
+		{
+			for (i64 i = 0; i < m_count; i++)
+				m_buffer[i].~T();
+		}
+
+		m_count = 0;
+	}
+
+	template<class T>
+	inline i64 FrameVector<T>::size() const
+	{
+		return m_count;
+	}
+
+	template<class T>
+	inline i64 FrameVector<T>::capacity() const
+	{
+		return m_capacity;
+	}
+
+	template<class T>
+	inline void FrameVector<T>::reserve(i64 cap)
+	{
+		if (cap > m_capacity)
+		{
+			BLAH_ASSERT(m_buffer == nullptr || m_frame == FrameArena::stats().frame, "FrameVector was used after its frame ended");
+
+			if ((size_t)cap > SIZE_MAX / 2 / sizeof(T))
+			{
+				BLAH_ASSERT(false, "FrameVector capacity is too large");
+				return;
+			}
+
+			i64 new_capacity = (m_capacity > 0 ? m_capacity : 8);
+			while (new_capacity < cap)
+				new_capacity *= 2;
+
+			// most of the time the buffer is the last thing allocated, and can just be bumped
+			if (m_buffer && FrameArena::extend(m_buffer, sizeof(T) * m_capacity, sizeof(T) * new_capacity))
+			{
+				m_capacity = new_capacity;
+				return;
+			}
+
+			T* new_buffer = (T*)FrameArena::alloc(sizeof(T) * new_capacity, alignof(T));
+			if (new_buffer == nullptr)
+				return;
+
+			if constexpr (std::is_trivially_copyable<T>())
+			{
+				if (m_count > 0)
+					memcpy(new_buffer, m_buffer, sizeof(T) * m_count);
+			}
+			else
+			{
+				for (i64 i = 0; i < m_count; i++)
+				{
+					new (new_buffer + i) T(std::move(m_buffer[i]));
+					m_buffer[i].~T();
+				}
+			}
+
+			m_buffer = new_buffer;
+			m_capacity = new_capacity;
+			m_frame = FrameArena::stats().frame;
+		}
+	}
+
+	template<class T>
+	inline void FrameVector<T>::resize(i64 new_count)
+	{
+		if (new_count < m_count)
+		{
+			if constexpr (!std::is_trivially_destructible<T>())
+			{
+				for (i64 i = new_count; i < m_count; i++)
+					m_buffer[i].~T();
+			}
+
+			m_count = new_count;
+		}
+		else
+			expand(new_count - m_count);
+	}
+
+	template<class T>
+	inline T* FrameVector<T>::expand(i64 amount)
+	{
+		if (amount > 0)
+		{
+			i64 count = m_count;
+
+			reserve(count + amount);
+			if (m_capacity < count + amount)
+				return nullptr;
+
+			for (i64 i = 0; i < amount; i++)
+				new (m_buffer + count + i) T();
+
+			m_count += amount;
+			return &m_buffer[count];
+		}
+
+		return m_buffer;
+	}
+
+	template<class T>
+	inline void FrameVector<T>::push_back(const T& item)
+	{
+		if (m_count >= m_capacity)
+		{
+			reserve(m_count + 1);
+			if (m_count >= m_capacity)
+				return;
+		}
+
+		new (m_buffer + m_count) T(item);
+		m_count++;
+	}
+
+	template<class T>
+	inline void FrameVector<T>::push_back(T&& item)
+	{
+		if (m_count >= m_capacity)
+		{
+			reserve(m_count + 1);
+			if (m_count >= m_capacity)
+				return;
+		}
+
+		new (m_buffer + m_count) T(std::move(item));
+		m_count++;
+	}
+
+	template<class T>
+	template<class ...Args>
+	inline void FrameVector<T>::emplace_back(Args&& ...args)
+	{
+		if (m_count >= m_capacity)
+		{
+			reserve(m_count + 1);
+			if (m_count >= m_capacity)
+				return;
+		}
+
+		new (m_buffer + m_count) T(std::forward<Args>(args)...);
+		m_count++;
+	}
+
+	template<class T>
+	inline T& FrameVector<T>::operator[](i64 index)
+	{
+		BLAH_ASSERT(index >= 0 && index < m_count, "Index out of range");
+		return m_buffer[index];
+	}
+
+	template<class T>
+	inline const T& FrameVector<T>::operator[](i64 index) const
+	{
+		BLAH_ASSERT(index >= 0 && index < m_count, "Index out of range");
+		return m_buffer[index];
+	}
+
+	template<class T>
+	inline T* FrameVector<T>::data()
+	{
+		return m_buffer;
+	}
+
+	template<class T>
+	inline const T* FrameVector<T>::data() const
+	{
+		return m_buffer;
+	}
+
+	template<class T>
+	inline T* FrameVector<T>::begin()
+	{
+		return m_buffer;
+	}
+
+	template<class T>
+	inline const T* FrameVector<T>::begin() const
+	{
+		return m_buffer;
+	}
+
+	template<class T>
+	inline T* FrameVector<T>::end()
+	{
+		return m_buffer + m_count;
+	}
+
+	template<class T>
+	inline const T* FrameVector<T>::end() const
+	{
+		return m_buffer + m_count;
+	}
+
+	template<class T>
+	inline T& FrameVector<T>::front()
+	{
+		BLAH_ASSERT(m_count > 0, "Index out of range");
+		return m_buffer[0];
+	}
+
+	template<class T>
+	inline const T& FrameVector<T>::front() const
+	{
+		BLAH_ASSERT(m_count > 0, "Index out of range");
+		return m_buffer[0];
+	}
+
+	template<class T>
+	inline T& FrameVector<T>::back()
+	{
+		BLAH_ASSERT(m_count > 0, "Index out of range");
+		return m_buffer[m_count - 1];
+	}
+
+	template<class T>
+	inline const T& FrameVector<T>::back() const
+	{
+		BLAH_ASSERT(m_count > 0, "Index out of range");
+		return m_buffer[m_count - 1];
+	}
+
+	template<class T>
+	inline T FrameVector<T>::pop()
+	{
+		BLAH_ASSERT(m_count > 0, "Index out of range");
+
+		T value = std::move(m_buffer[m_count - 1]);
+		m_buffer[m_count - 1].~T();
+		m_count--;
+		return value;
+	}
+}
@@ -3,6 +3,7 @@
 #include <blah_vector.h>
 #include <blah_stackvector.h>
 #include <blah_string.h>
+#include <blah_stringid.h>
 #include <blah_spatial.h>
 #include <blah_image.h>
 
@@ -254,6 +255,9 @@ namespace Blah
 		// Name of the Uniform
 		String name;
 
+		// Interned name of the Uniform, assigned when the Shader is created
+		StringId id;
+
 		// The Value type of the Uniform
 		UniformType type;
 
@@ -423,6 +427,14 @@ namespace Blah
 		// If the Texture Format is not RGBA, this won't do anything.
 		void set_data(const Color* data);
 
+		// Sets the data of a rectangle within the Texture.
+		// Note that the data should be the same format as the Texture, and rect.w * rect.h in size. There is no row padding.
+		virtual void set_data(const u8* data, const Recti& rect) = 0;
+
+		// Sets the data of a rectangle within the Texture to the provided Color buffer.
+		// If the Texture Format is not RGBA, this won't do anything.
+		void set_data(const Color* data, const Recti& rect);
+
 		// Gets the data of the Texture.
 		// Note that the data will be written to in the same format as the Texture,
 		// and you should allocate enough space for the full texture. There is no row padding.
@@ -558,6 +570,9 @@ namespace Blah
 		// Sets the texture
 		void set_texture(int register_index, const TextureRef& texture);
 
+		// Sets the texture, finding the uniform by comparing interned names
+		void set_texture(StringId name, const TextureRef& texture, int array_index = 0);
+
 		// Gets the texture, or an empty reference if invalid
 		TextureRef get_texture(const char* name, int array_index = 0) const;
 
@@ -570,6 +585,9 @@ namespace Blah
 		// Sets the sampler
 		void set_sampler(int register_index, const TextureSampler& sampler);
 
+		// Sets the sampler, finding the uniform by comparing interned names
+		void set_sampler(StringId name, const TextureSampler& sampler, int array_index = 0);
+
 		// Gets the sampler
 		TextureSampler get_sampler(const char* name, int array_index = 0) const;
 
@@ -581,6 +599,9 @@ namespace Blah
 		// can be set.
 		void set_value(const char* name, const float* value, i64 length);
 
+		// Sets the value, finding the uniform by comparing interned names
+		void set_value(StringId name, const float* value, i64 length);
+
 		// Shorthands to more easily assign uniform values
 		void set_value(const char* name, float value);
 		void set_value(const char* name, const Vec2f& value);
@@ -601,6 +622,9 @@ namespace Blah
 		// Checks if the shader attached to the material has a uniform value with the given name
 		bool has_value(const char* name) const;
 
+		// Checks if the shader attached to the material has a uniform value with the given interned name
+		bool has_value(StringId name) const;
+
 		// Returns the internal Texture buffer
 		const Vector<TextureRef>& textures() const;
 
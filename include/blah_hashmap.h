@@ -0,0 +1,434 @@
+#pragma once
+#include <blah_common.h>
+#include <blah_memory.h>
+#include <blah_vector.h>
+#include <functional> // for std::hash
+
+namespace Blah
+{
+	// An open-addressing hash map, using robin hood hashing.
+	// Entries are stored in flat arrays rather than per-node allocations, so lookups stay cache-friendly.
+	// Keys are hashed with `std::hash` by default, which Blah's Strings (including FilePath) specialize.
+	// Inserting or erasing may move entries, so pointers to them are only valid until the map is modified.
+	template<class K, class V, class Hasher = std::hash<K>>
+	class HashMap
+	{
+	public:
+		struct Entry
+		{
+			K key;
+			V value;
+		};
+
+	private:
+		struct Slot
+		{
+			// the key's hash, to skip most key comparisons
+			u32 hash;
+
+			// distance from the slot the key hashed to, plus one. 0 is an empty slot.
+			u32 distance;
+		};
+
+		Entry* m_entries = nullptr;
+		Slot* m_slots = nullptr;
+		i64 m_count = 0;
+		i64 m_capacity = 0;
+
+		static u32 hash_of(const K& key);
+		i64 find_index(const K& key) const;
+		Entry* insert_new(u32 hash, Entry&& entry);
+		void rehash(i64 new_capacity);
+
+	public:
+
+		template<class E, class S>
+		class Iterator
+		{
+		private:
+			E* m_entries;
+			S* m_slots;
+			i64 m_index;
+			i64 m_capacity;
+
+		public:
+			Iterator(E* entries, S* slots, i64 index, i64 capacity)
+				: m_entries(entries), m_slots(slots), m_index(index), m_capacity(capacity)
+			{
+				while (m_index < m_capacity && m_slots[m_index].distance == 0)
+					m_index++;
+			}
+
+			E& operator*() const { return m_entries[m_index]; }
+			E* operator->() const { return &m_entries[m_index]; }
+			bool operator!=(const Iterator& rhs) const { return m_index != rhs.m_index; }
+			bool operator==(const Iterator& rhs) const { return m_index == rhs.m_index; }
+
+			Iterator& operator++()
+			{
+				m_index++;
+				while (m_index < m_capacity && m_slots[m_index].distance == 0)
+					m_index++;
+				return *this;
+			}
+		};
+
+		using iterator = Iterator<Entry, Slot>;
+		using const_iterator = Iterator<const Entry, const Slot>;
+
+		HashMap() = default;
+		HashMap(i64 capacity);
+		HashMap(const HashMap& src);
+		HashMap(HashMap&& src) noexcept;
+		~HashMap();
+
+		HashMap& operator=(const HashMap& src);
+		HashMap& operator=(HashMap&& src) noexcept;
+
+		// gets the value of the key, or null if it isn't in the map
+		V* find(const K& key);
+		const V* find(const K& key) const;
+
+		// checks if the key is in the map
+		bool contains(const K& key) const;
+
+		// sets the value of the key, adding it if it isn't in the map
+		V& insert(const K& key, const V& value);
+		V& insert(const K& key, V&& value);
+
+		// gets the value of the key, adding a default value if it isn't in the map
+		V& operator[](const K& key);
+
+		// removes the key, returning false if it wasn't in the map
+		bool erase(const K& key);
+
+		// ensures the map can hold at least `count` entries without growing
+		void reserve(i64 count);
+
+		// removes every entry, keeping the allocated memory
+		void clear();
+
+		// removes every entry and frees the allocated memory
+		void dispose();
+
+		i64 size() const;
+		i64 capacity() const;
+
+		iterator begin();
+		iterator end();
+		const_iterator begin() const;
+		const_iterator end() const;
+	};
+
+	template<class K, class V, class H>
+	inline HashMap<K, V, H>::HashMap(i64 capacity)
+	{
+		reserve(capacity);
+	}
+
+	template<class K, class V, class H>
+	inline HashMap<K, V, H>::HashMap(const HashMap& src)
+	{
+		reserve(src.m_count);
+		for (auto& it : src)
+			insert(it.key, it.value);
+	}
+
+	template<class K, class V, class H>
+	inline HashMap<K, V, H>::HashMap(HashMap&& src) noexcept
+	{
+		m_entries = src.m_entries;
+		m_slots = src.m_slots;
+		m_count = src.m_count;
+		m_capacity = src.m_capacity;
+		src.m_entries = nullptr;
+		src.m_slots = nullptr;
+		src.m_count = src.m_capacity = 0;
+	}
+
+	template<class K, class V, class H>
+	inline HashMap<K, V, H>::~HashMap()
+	{
+		dispose();
+	}
+
+	template<class K, class V, class H>
+	inline HashMap<K, V, H>& HashMap<K, V, H>::operator=(const HashMap& src)
+	{
+		if (this != &src)
+		{
+			clear();
+			reserve(src.m_count);
+			for (auto& it : src)
+				insert(it.key, it.value);
+		}
+
+		return *this;
+	}
+
+	template<class K, class V, class H>
+	inline HashMap<K, V, H>& HashMap<K, V, H>::operator=(HashMap&& src) noexcept
+	{
+		if (this != &src)
+		{
+			dispose();
+			m_entries = src.m_entries;
+			m_slots = src.m_slots;
+			m_count = src.m_count;
+			m_capacity = src.m_capacity;
+			src.m_entries = nullptr;
+			src.m_slots = nullptr;
+			src.m_count = src.m_capacity = 0;
+		}
+
+		return *this;
+	}
+
+	template<class K, class V, class H>
+	inline u32 HashMap<K, V, H>::hash_of(const K& key)
+	{
+		// mix the hash, as std::hash is often the identity for integers
+		u64 hash = (u64)H()(key);
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdULL;
+		hash ^= hash >> 33;
+		return (u32)hash;
+	}
+
+	template<class K, class V, class H>
+	inline i64 HashMap<K, V, H>::find_index(const K& key) const
+	{
+		if (m_count <= 0)
+			return -1;
+
+		u32 hash = hash_of(key);
+		i64 mask = m_capacity - 1;
+		i64 index = hash & mask;
+
+		// robin hood hashing keeps entries sorted by distance, so the search can
+		// stop as soon as it finds an entry closer to its home than the key would be
+		for (u32 distance = 1; ; distance++, index = (index + 1) & mask)
+		{
+			auto& slot = m_slots[index];
+			if (slot.distance < distance)
+				return -1;
+			if (slot.hash == hash && m_entries[index].key == key)
+				return index;
+		}
+	}
+
+	template<class K, class V, class H>
+	inline typename HashMap<K, V, H>::Entry* HashMap<K, V, H>::insert_new(u32 hash, Entry&& entry)
+	{
+		if ((m_count + 1) * 8 > m_capacity * 7)
+			rehash(m_capacity > 0 ? m_capacity * 2 : 8);
+
+		Entry* result = nullptr;
+		Slot slot = { hash, 1 };
+		i64 mask = m_capacity - 1;
+
+		for (i64 index = hash & mask; ; index = (index + 1) & mask, slot.distance++)
+		{
+			auto& it = m_slots[index];
+
+			if (it.distance == 0)
+			{
+				new (m_entries + index) Entry(std::move(entry));
+				it = slot;
+				m_count++;
+				return (result ? result : m_entries + index);
+			}
+
+			// take the place of entries closer to their home, and keep inserting the one that was there
+			if (it.distance < slot.distance)
+			{
+				Slot swap_slot = it;
+				it = slot;
+				slot = swap_slot;
+
+				Entry swap_entry(std::move(m_entries[index]));
+				m_entries[index] = std::move(entry);
+				entry = std::move(swap_entry);
+
+				if (result == nullptr)
+					result = m_entries + index;
+			}
+		}
+	}
+
+	template<class K, class V, class H>
+	inline void HashMap<K, V, H>::rehash(i64 new_capacity)
+	{
+		Entry* prev_entries = m_entries;
+		Slot* prev_slots = m_slots;
+		i64 prev_capacity = m_capacity;
+
+		m_entries = (Entry*)Memory::alloc(sizeof(Entry) * new_capacity, alignof(Entry));
+		m_slots = (Slot*)Memory::alloc(sizeof(Slot) * new_capacity, alignof(Slot));
+		m_capacity = new_capacity;
+		m_count = 0;
+
+		for (i64 i = 0; i < new_capacity; i++)
+			m_slots[i].distance = 0;
+
+		for (i64 i = 0; i < prev_capacity; i++)
+		{
+			if (prev_slots[i].distance > 0)
+			{
+				insert_new(prev_slots[i].hash, std::move(prev_entries[i]));
+				prev_entries[i].~Entry();
+			}
+		}
+
+		Memory::free(prev_entries);
+		Memory::free(prev_slots);
+	}
+
+	template<class K, class V, class H>
+	inline V* HashMap<K, V, H>::find(const K& key)
+	{
+		i64 index = find_index(key);
+		return (index >= 0 ? &m_entries[index].value : nullptr);
+	}
+
+	template<class K, class V, class H>
+	inline const V* HashMap<K, V, H>::find(const K& key) const
+	{
+		i64 index = find_index(key);
+		return (index >= 0 ? &m_entries[index].value : nullptr);
+	}
+
+	template<class K, class V, class H>
+	inline bool HashMap<K, V, H>::contains(const K& key) const
+	{
+		return find_index(key) >= 0;
+	}
+
+	template<class K, class V, class H>
+	inline V& HashMap<K, V, H>::insert(const K& key, const V& value)
+	{
+		i64 index = find_index(key);
+		if (index >= 0)
+			return m_entries[index].value = value;
+		return insert_new(hash_of(key), Entry{ key, value })->value;
+	}
+
+	template<class K, class V, class H>
+	inline V& HashMap<K, V, H>::insert(const K& key, V&& value)
+	{
+		i64 index = find_index(key);
+		if (index >= 0)
+			return m_entries[index].value = std::move(value);
+		return insert_new(hash_of(key), Entry{ key, std::move(value) })->value;
+	}
+
+	template<class K, class V, class H>
+	inline V& HashMap<K, V, H>::operator[](const K& key)
+	{
+		i64 index = find_index(key);
+		if (index >= 0)
+			return m_entries[index].value;
+		return insert_new(hash_of(key), Entry{ key, V() })->value;
+	}
+
+	template<class K, class V, class H>
+	inline bool HashMap<K, V, H>::erase(const K& key)
+	{
+		i64 index = find_index(key);
+		if (index < 0)
+			return false;
+
+		m_entries[index].~Entry();
+
+		// shift the following entries back, so there are never holes in a probe sequence
+		i64 mask = m_capacity - 1;
+		i64 next = (index + 1) & mask;
+		while (m_slots[next].distance > 1)
+		{
+			new (m_entries + index) Entry(std::move(m_entries[next]));
+			m_entries[next].~Entry();
+			m_slots[index] = m_slots[next];
+			m_slots[index].distance--;
+
+			index = next;
+			next = (next + 1) & mask;
+		}
+
+		m_slots[index].distance = 0;
+		m_count--;
+		return true;
+	}
+
+	template<class K, class V, class H>
+	inline void HashMap<K, V, H>::reserve(i64 count)
+	{
+		i64 new_capacity = (m_capacity > 0 ? m_capacity : 8);
+		while (count * 8 > new_capacity * 7)
+			new_capacity *= 2;
+
+		if (new_capacity > m_capacity)
+			rehash(new_capacity);
+	}
+
+	template<class K, class V, class H>
+	inline void HashMap<K, V, H>::clear()
+	{
+		for (i64 i = 0; i < m_capacity; i++)
+		{
+			if (m_slots[i].distance > 0)
+			{
+				m_entries[i].~Entry();
+				m_slots[i].distance = 0;
+			}
+		}
+
+		m_count = 0;
+	}
+
+	template<class K, class V, class H>
+	inline void HashMap<K, V, H>::dispose()
+	{
+		clear();
+		Memory::free(m_entries);
+		Memory::free(m_slots);
+		m_entries = nullptr;
+		m_slots = nullptr;
+		m_capacity = 0;
+	}
+
+	template<class K, class V, class H>
+	inline i64 HashMap<K, V, H>::size() const
+	{
+		return m_count;
+	}
+
+	template<class K, class V, class H>
+	inline i64 HashMap<K, V, H>::capacity() const
+	{
+		return m_capacity;
+	}
+
+	template<class K, class V, class H>
+	inline typename HashMap<K, V, H>::iterator HashMap<K, V, H>::begin()
+	{
+		return iterator(m_entries, m_slots, 0, m_capacity);
+	}
+
+	template<class K, class V, class H>
+	inline typename HashMap<K, V, H>::iterator HashMap<K, V, H>::end()
+	{
+		return iterator(m_entries, m_slots, m_capacity, m_capacity);
+	}
+
+	template<class K, class V, class H>
+	inline typename HashMap<K, V, H>::const_iterator HashMap<K, V, H>::begin() const
+	{
+		return const_iterator(m_entries, m_slots, 0, m_capacity);
+	}
+
+	template<class K, class V, class H>
+	inline typename HashMap<K, V, H>::const_iterator HashMap<K, V, H>::end() const
+	{
+		return const_iterator(m_entries, m_slots, m_capacity, m_capacity);
+	}
+}
@@ -7,6 +7,19 @@
 namespace Blah
 {
 	class Stream;
+	struct ImageLoadResult;
+
+	// PNG row filters. Filtering makes image data compress better, at some cost to encoding speed.
+	enum class PngFilter
+	{
+		// picks the best filter for each row (slowest, usually smallest)
+		Adaptive = -1,
+		None = 0,
+		Sub = 1,
+		Up = 2,
+		Average = 3,
+		Paeth = 4,
+	};
 
 	// A 2D Bitmap stored on the CPU.
 	// For drawing images to the screen, use a Texture.
@@ -37,6 +50,20 @@ namespace Blah
 		// creates the image from a stream, and returns true if successful
 		bool from_stream(Stream& stream);
 
+		// creates the image from encoded image data in memory, and returns true if successful
+		bool from_memory(const u8* data, size_t length);
+
+		// Loads many image files at once. Each file is mapped into memory and decoded,
+		// spread across `thread_count` threads (0 uses every available hardware thread).
+		// This blocks the calling thread until every image has been loaded. To read files in the
+		// background instead, use `File::read_async` and decode the data with `Image::from_memory`.
+		// `on_loaded` is called as each image finishes, in whatever order they complete. It may be called
+		// from a worker thread, but is never called from more than one thread at a time.
+		// The returned results are in the same order as `paths`.
+		static Vector<ImageLoadResult> load_many(
+			const Vector<FilePath>& paths, int thread_count = 0,
+			const Func<void, const ImageLoadResult&>& on_loaded = nullptr);
+
 		// disposes the image and resets its values to defaults
 		void dispose();
 
@@ -47,11 +74,27 @@ namespace Blah
 		// data must be at least rect.w * rect.h in size!
 		void set_pixels(const Recti& rect, Color* data);
 
-		// saves the image to a png file
-		bool save_png(const FilePath& file) const;
+		// saves the image to a png file.
+		// `compression_level` is the zlib level from 0 to 9, where 0 stores the data uncompressed (fastest).
+		// Note that the built-in compressor treats levels 1 to 4 the same as 5.
+		bool save_png(const FilePath& file, int compression_level = 5, PngFilter filter = PngFilter::None) const;
+
+		// saves the image to a png file.
+		// `compression_level` is the zlib level from 0 to 9, where 0 stores the data uncompressed (fastest).
+		// Note that the built-in compressor treats levels 1 to 4 the same as 5.
+		bool save_png(Stream& stream, int compression_level = 5, PngFilter filter = PngFilter::None) const;
+
+		// Takes ownership of the image and saves it to a png file on a background thread.
+		// Saves are run one at a time, in the order they were requested.
+		// `on_complete` is called from the background thread once the file is written.
+		// Queued saves are finished when the App shuts down, so this must be called while the App is running.
+		// If threading is disabled (BLAH_NO_THREADING) the image is saved immediately.
+		static void save_png_async(
+			Image&& image, const FilePath& file, int compression_level = 0, PngFilter filter = PngFilter::None,
+			const Func<void, bool>& on_complete = nullptr);
 
-		// saves the image to a png file
-		bool save_png(Stream& stream) const;
+		// Blocks until every pending `save_png_async` call has finished
+		static void wait_for_async_saves();
 
 		// saves the image to a jpg file
 		bool save_jpg(const FilePath& file, int quality) const;
@@ -71,4 +114,24 @@ namespace Blah
 		// we should let it free the data if it created it.
 		bool m_stbi_ownership;
 	};
+
+	// The result of loading a single image with `Image::load_many`
+	struct ImageLoadResult
+	{
+		// index of the path passed to `Image::load_many`
+		int index = 0;
+
+		// the path the image was loaded from
+		FilePath path;
+
+		// the loaded image. this is empty if loading failed.
+		Image image;
+
+		// whether the image was loaded successfully
+		bool success = false;
+
+		// time spent loading the image, in ticks (microseconds).
+		// the file is mapped and read as it's decoded, so this covers both.
+		u64 load_ticks = 0;
+	};
 }
\ No newline at end of file
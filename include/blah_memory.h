@@ -0,0 +1,112 @@
+#pragma once
+#include <blah_common.h>
+#include <cstddef>     // for std::max_align_t
+
+namespace Blah
+{
+	namespace Memory
+	{
+		// default alignment of allocations
+		constexpr size_t default_alignment = alignof(std::max_align_t);
+
+		// What an allocation is used for, to track where memory goes.
+		enum class Tag
+		{
+			// anything not otherwise tagged
+			General,
+
+			// heap storage of Strings
+			String,
+
+			// Image pixels & image decoding
+			Image,
+
+			// Font data & glyph rasterization
+			Font,
+
+			// Audio data & decoding
+			Audio,
+
+			// Stream buffers
+			Stream,
+
+			// Graphics resources & batching
+			Graphics,
+
+			// free for use by the application
+			User0,
+			User1,
+			User2,
+			User3,
+
+			Count
+		};
+
+		// Functions used to allocate all of Blah's memory.
+		// `realloc` can be null, in which case memory is moved with alloc & free.
+		struct Hooks
+		{
+			void* (*alloc)(size_t size, size_t alignment, void* user) = nullptr;
+			void* (*realloc)(void* ptr, size_t size, size_t alignment, void* user) = nullptr;
+			void (*free)(void* ptr, void* user) = nullptr;
+			void* user = nullptr;
+		};
+
+		// Memory statistics for a single Tag
+		struct Stats
+		{
+			// bytes currently allocated
+			size_t bytes = 0;
+
+			// the most bytes that have been allocated at once
+			size_t peak_bytes = 0;
+
+			// allocations currently alive
+			size_t allocations = 0;
+
+			// allocations made in total
+			size_t total_allocations = 0;
+		};
+
+		// Sets the allocation hooks. Memory is always freed with the hooks it was allocated with,
+		// so this can be changed at any time. A limited number of hooks can be set over the
+		// lifetime of the application, after which this fails and returns false.
+		bool set_hooks(const Hooks& hooks);
+
+		// Allocates memory, tagged with the current tag (see `TagScope`)
+		void* alloc(size_t size, size_t alignment = default_alignment);
+
+		// Allocates memory with the given tag
+		void* alloc(size_t size, size_t alignment, Tag tag);
+
+		// Resizes memory allocated with `alloc`, keeping its alignment & tag.
+		// If `ptr` is null this is the same as `alloc`.
+		void* realloc(void* ptr, size_t size);
+
+		// Frees memory allocated with `alloc` or `realloc`
+		void free(void* ptr);
+
+		// gets the memory statistics of the given tag
+		Stats stats(Tag tag);
+
+		// gets the name of the given tag
+		const char* tag_name(Tag tag);
+
+		// gets the tag used by allocations on the current thread
+		Tag current_tag();
+
+		// Tags allocations made on the current thread while the scope exists
+		class TagScope
+		{
+		public:
+			TagScope(Tag tag);
+			~TagScope();
+
+			TagScope(const TagScope&) = delete;
+			TagScope& operator=(const TagScope&) = delete;
+
+		private:
+			Tag m_previous;
+		};
+	}
+}
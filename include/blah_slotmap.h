@@ -0,0 +1,281 @@
+#pragma once
+#include <blah_common.h>
+#include <blah_vector.h>
+
+namespace Blah
+{
+	// A 32-bit handle to an element in a SlotMap.
+	// The lower bits are the slot index, and the upper bits are the slot's generation,
+	// so a handle to a removed element is never mistaken for whatever reuses its slot.
+	template<class T>
+	struct Handle
+	{
+		static constexpr u32 index_bits = 20;
+		static constexpr u32 index_mask = (1u << index_bits) - 1;
+		static constexpr u32 max_generation = (1u << (32 - index_bits)) - 1;
+
+		// the raw handle value. 0 is never a valid handle.
+		u32 id = 0;
+
+		Handle() = default;
+		Handle(u32 index, u32 generation)
+			: id((generation << index_bits) | index) {}
+
+		u32 index() const { return id & index_mask; }
+		u32 generation() const { return id >> index_bits; }
+
+		bool operator==(const Handle& rhs) const { return id == rhs.id; }
+		bool operator!=(const Handle& rhs) const { return id != rhs.id; }
+		explicit operator bool() const { return id != 0; }
+	};
+
+	// A container that stores its elements densely, and hands out generation-checked Handles to them.
+	// Adding, removing, and looking up elements by Handle are all O(1).
+	// Removing an element moves the last element into its place, so pointers to
+	// elements (and their order) are not stable, but Handles are.
+	template<class T>
+	class SlotMap
+	{
+	private:
+		struct Slot
+		{
+			// index into the dense array if the slot is used, otherwise the next free slot
+			u32 index;
+			u32 generation;
+		};
+
+		Vector<T> m_values;
+		Vector<u32> m_value_slots;
+		Vector<Slot> m_slots;
+		u32 m_free = 0;
+		u32 m_free_count = 0;
+
+		u32 alloc_slot();
+
+	public:
+		// the largest number of elements a SlotMap can hold
+		static constexpr i64 max_size = Handle<T>::index_mask;
+
+		// adds an element and returns its handle
+		Handle<T> add(const T& value);
+		Handle<T> add(T&& value);
+		template<class ...Args>
+		Handle<T> emplace(Args&&...args);
+
+		// removes the element, returning false if the handle was not valid
+		bool remove(Handle<T> handle);
+
+		// checks if the handle refers to an element in the SlotMap
+		bool contains(Handle<T> handle) const;
+
+		// gets the element, or null if the handle is not valid
+		T* get(Handle<T> handle);
+		const T* get(Handle<T> handle) const;
+
+		// gets the element. the handle must be valid.
+		T& operator[](Handle<T> handle);
+		const T& operator[](Handle<T> handle) const;
+
+		// gets the handle of the element at the given dense index
+		Handle<T> handle_at(i64 index) const;
+
+		void reserve(i64 capacity);
+		void clear();
+		i64 size() const;
+
+		// the elements are contiguous, in no particular order
+		T* data();
+		const T* data() const;
+		T* begin();
+		const T* begin() const;
+		T* end();
+		const T* end() const;
+	};
+
+	template<class T>
+	inline u32 SlotMap<T>::alloc_slot()
+	{
+		u32 slot;
+
+		if (m_free_count > 0)
+		{
+			slot = m_free;
+			m_free = m_slots[slot].index;
+			m_free_count--;
+		}
+		else
+		{
+			BLAH_ASSERT(m_slots.size() < max_size, "SlotMap is full");
+			slot = (u32)m_slots.size();
+			m_slots.push_back({ 0, 1 });
+		}
+
+		m_slots[slot].index = (u32)m_values.size();
+		m_value_slots.push_back(slot);
+		return slot;
+	}
+
+	template<class T>
+	inline Handle<T> SlotMap<T>::add(const T& value)
+	{
+		u32 slot = alloc_slot();
+		m_values.push_back(value);
+		return Handle<T>(slot, m_slots[slot].generation);
+	}
+
+	template<class T>
+	inline Handle<T> SlotMap<T>::add(T&& value)
+	{
+		u32 slot = alloc_slot();
+		m_values.push_back(std::move(value));
+		return Handle<T>(slot, m_slots[slot].generation);
+	}
+
+	template<class T>
+	template<class ...Args>
+	inline Handle<T> SlotMap<T>::emplace(Args&&...args)
+	{
+		u32 slot = alloc_slot();
+		m_values.emplace_back(std::forward<Args>(args)...);
+		return Handle<T>(slot, m_slots[slot].generation);
+	}
+
+	template<class T>
+	inline bool SlotMap<T>::remove(Handle<T> handle)
+	{
+		if (!contains(handle))
+			return false;
+
+		u32 slot = handle.index();
+		u32 index = m_slots[slot].index;
+		u32 last = (u32)m_values.size() - 1;
+
+		// move the last element into the removed element's place
+		if (index != last)
+		{
+			m_values[index] = std::move(m_values[last]);
+			m_value_slots[index] = m_value_slots[last];
+			m_slots[m_value_slots[index]].index = index;
+		}
+
+		m_values.pop();
+		m_value_slots.pop();
+
+		// invalidate existing handles to the slot, and add it to the free list
+		auto& it = m_slots[slot];
+		it.generation = (it.generation >= Handle<T>::max_generation ? 1 : it.generation + 1);
+		it.index = m_free;
+		m_free = slot;
+		m_free_count++;
+		return true;
+	}
+
+	template<class T>
+	inline bool SlotMap<T>::contains(Handle<T> handle) const
+	{
+		u32 slot = handle.index();
+		if (handle.id == 0 || slot >= m_slots.size())
+			return false;
+
+		auto& it = m_slots[slot];
+		return it.generation == handle.generation() &&
+			it.index < m_value_slots.size() &&
+			m_value_slots[it.index] == slot;
+	}
+
+	template<class T>
+	inline T* SlotMap<T>::get(Handle<T> handle)
+	{
+		if (!contains(handle))
+			return nullptr;
+		return &m_values[m_slots[handle.index()].index];
+	}
+
+	template<class T>
+	inline const T* SlotMap<T>::get(Handle<T> handle) const
+	{
+		if (!contains(handle))
+			return nullptr;
+		return &m_values[m_slots[handle.index()].index];
+	}
+
+	template<class T>
+	inline T& SlotMap<T>::operator[](Handle<T> handle)
+	{
+		BLAH_ASSERT(contains(handle), "Invalid SlotMap Handle");
+		return m_values[m_slots[handle.index()].index];
+	}
+
+	template<class T>
+	inline const T& SlotMap<T>::operator[](Handle<T> handle) const
+	{
+		BLAH_ASSERT(contains(handle), "Invalid SlotMap Handle");
+		return m_values[m_slots[handle.index()].index];
+	}
+
+	template<class T>
+	inline Handle<T> SlotMap<T>::handle_at(i64 index) const
+	{
+		BLAH_ASSERT(index >= 0 && index < m_values.size(), "Index out of range");
+		u32 slot = m_value_slots[index];
+		return Handle<T>(slot, m_slots[slot].generation);
+	}
+
+	template<class T>
+	inline void SlotMap<T>::reserve(i64 capacity)
+	{
+		m_values.reserve(capacity);
+		m_value_slots.reserve(capacity);
+		m_slots.reserve(capacity);
+	}
+
+	template<class T>
+	inline void SlotMap<T>::clear()
+	{
+		// removing everything keeps generations, so existing handles stay invalid
+		while (m_values.size() > 0)
+			remove(handle_at(m_values.size() - 1));
+	}
+
+	template<class T>
+	inline i64 SlotMap<T>::size() const
+	{
+		return m_values.size();
+	}
+
+	template<class T>
+	inline T* SlotMap<T>::data()
+	{
+		return m_values.data();
+	}
+
+	template<class T>
+	inline const T* SlotMap<T>::data() const
+	{
+		return m_values.data();
+	}
+
+	template<class T>
+	inline T* SlotMap<T>::begin()
+	{
+		return m_values.begin();
+	}
+
+	template<class T>
+	inline const T* SlotMap<T>::begin() const
+	{
+		return m_values.begin();
+	}
+
+	template<class T>
+	inline T* SlotMap<T>::end()
+	{
+		return m_values.end();
+	}
+
+	template<class T>
+	inline const T* SlotMap<T>::end() const
+	{
+		return m_values.end();
+	}
+}
@@ -2,6 +2,7 @@
 #include <blah_common.h>
 #include <blah_string.h>
 #include <blah_vector.h>
+#include <blah_hashmap.h>
 #include <blah_subtexture.h>
 #include <blah_font.h>
 
@@ -43,6 +44,9 @@ namespace Blah
 			Subtexture subtexture;
 			float advance = 0;
 			Vec2f offset;
+
+			// the atlas cell the glyph is cached in. only used by dynamic SpriteFonts.
+			int cell = -1;
 		};
 
 		struct Kerning
@@ -52,6 +56,41 @@ namespace Blah
 			float value;
 		};
 
+		// Size of a string of text, measured with `measure`
+		struct Measurement
+		{
+			// size of the text, in pixels (the same as `width_of` and `height_of`)
+			Vec2f size;
+
+			// the width of each line, in pixels
+			Vector<float> line_widths;
+		};
+
+		// Timings of the last `rebuild` or `rebuild_sdf`, in microseconds
+		struct BuildStats
+		{
+			// number of glyphs that were rasterized
+			int glyph_count = 0;
+
+			// number of threads the glyphs were rasterized on
+			int thread_count = 0;
+
+			// time spent rasterizing glyphs
+			u64 raster_ticks = 0;
+
+			// time spent packing glyphs into atlas pages
+			u64 pack_ticks = 0;
+
+			// time spent creating the atlas textures
+			u64 upload_ticks = 0;
+
+			// time spent finding kerning pairs
+			u64 kerning_ticks = 0;
+
+			// total build time
+			u64 total_ticks = 0;
+		};
+
 		// SpriteFont name
 		String name;
 
@@ -67,6 +106,10 @@ namespace Blah
 		// Line Gap, in pixels
 		float line_gap = 0;
 
+		// Number of threads used to rasterize glyphs when rebuilding.
+		// Values <= 0 use every available hardware thread.
+		int build_threads = 0;
+
 		SpriteFont() = default;
 		SpriteFont(const FilePath& file, float size);
 		SpriteFont(const FilePath& file, float size, const CharSet& charset);
@@ -76,12 +119,24 @@ namespace Blah
 		// releases all assets used by the spritefont
 		void clear();
 
+		// whether the spritefont rasterizes glyphs on demand (see `rebuild_dynamic`)
+		bool is_dynamic() const { return (bool)m_font; }
+
+		// whether the spritefont's glyphs are signed distance fields (see `rebuild_sdf`)
+		bool is_sdf() const { return m_sdf_spread > 0; }
+
+		// how many pixels the signed distance field extends past the edges of each glyph, or 0 if it's not an SDF spritefont
+		int sdf_spread() const { return m_sdf_spread; }
+
 		// gets the height of the sprite font
 		float height() const { return ascent - descent; }
 
 		// gets the line height of the sprite font (height + line gap)
 		float line_height() const { return ascent - descent + line_gap; }
 
+		// gets the timings of the last rebuild
+		const BuildStats& build_stats() const { return m_build_stats; }
+
 		// returns a list of all texture atlases
 		const Vector<TextureRef>& textures() { return m_atlas; }
 
@@ -94,12 +149,48 @@ namespace Blah
 		// calculates the height of the given string
 		float height_of(const String& text) const;
 
+		// measures the size of the given string, and the width of each line, in a single pass
+		Measurement measure(const String& text) const;
+
+		// measures the size of the given string, and the width of each line, reusing the result's memory
+		void measure(const String& text, Measurement& result) const;
+
+		// measures the size of many strings at once. `sizes` must have room for `count` results.
+		void measure(const String* texts, int count, Vec2f* sizes) const;
+
 		// disposes the existing spritefont data and rebuilds from the given font file
 		void rebuild(const FilePath& file, float size, const CharSet& charset);
 
 		// disposes the existing spritefont data and rebuilds from the given font
 		void rebuild(const FontRef& font, float size, const CharSet& charset);
 
+		// Disposes the existing spritefont data and rebuilds from the given font as signed distance fields.
+		// SDF spritefonts stay sharp at any size when drawn with `Batch::str`, and can have outlines & shadows
+		// (see `Batch::push_sdf_style`). `spread` is how many pixels the distance field extends past the edges
+		// of each glyph, which limits how wide outlines and shadows can be.
+		void rebuild_sdf(const FontRef& font, float size, const CharSet& charset, int spread = 8);
+
+		// Disposes the existing spritefont data and creates a dynamic spritefont from the given font.
+		// Glyphs are rasterized the first time they're requested and cached in texture atlas pages
+		// of `page_size`. Once `max_pages` are full, the least recently used glyphs are evicted.
+		// Glyphs used during the current frame are never evicted, so if a single frame uses more glyphs
+		// than fit in `max_pages`, more pages are added.
+		void rebuild_dynamic(const FontRef& font, float size, int page_size = 1024, int max_pages = 4);
+
+		// Saves the spritefont's metrics, characters, kerning and atlas pages to a compact binary format,
+		// which can be loaded with `load` without needing the original Font. Dynamic spritefonts can't be saved.
+		// Note that the atlas pages are read back from the GPU.
+		bool save(Stream& stream) const;
+
+		// saves the spritefont to the given file
+		bool save(const FilePath& path) const;
+
+		// disposes the existing spritefont data and loads a spritefont saved with `save`
+		bool load(Stream& stream);
+
+		// disposes the existing spritefont data and loads a spritefont saved with `save`. the file is memory-mapped if possible.
+		bool load(const FilePath& path);
+
 		// gets the kerning between two characters
 		float get_kerning(Codepoint codepoint0, Codepoint codepoint1) const;
 
@@ -119,8 +210,46 @@ namespace Blah
 		const Character& operator[](Codepoint codepoint) const;
 
 	private:
-		Vector<Character> m_characters;
+		struct CacheCell
+		{
+			Codepoint codepoint = 0;
+			u64 last_used = 0;
+			u64 frame = 0;
+		};
+
+		// codepoints below this are looked up directly rather than through the hash table
+		static constexpr Codepoint direct_lookup_count = 256;
+
+		void build(const FontRef& font, float size, const CharSet& charset, int sdf_spread);
+		Vec2f measure(const char* text, bool first_line_only, Vector<float>* line_widths) const;
+		bool load(const u8* data, size_t length);
+		int find_character_index(Codepoint codepoint) const;
+		int add_character(Codepoint codepoint) const;
+		Character& find_character(Codepoint codepoint) const;
+		void cache_glyph(Character& ch) const;
+
+		// characters & atlas pages are added to lazily by dynamic spritefonts
+		mutable Vector<Character> m_characters;
 		Vector<Kerning> m_kerning;
-		Vector<TextureRef> m_atlas;
+		mutable Vector<TextureRef> m_atlas;
+
+		// character index + 1 for the first codepoints, or 0 if there is no character
+		mutable int m_direct_lookup[direct_lookup_count] = {};
+		// indices into `m_characters` and `m_kerning`
+		mutable HashMap<Codepoint, int> m_character_lookup;
+		HashMap<u64, int> m_kerning_lookup;
+
+		int m_sdf_spread = 0;
+		BuildStats m_build_stats;
+
+		// dynamic glyph cache
+		FontRef m_font;
+		float m_scale = 0;
+		int m_page_size = 0;
+		int m_max_pages = 0;
+		Point m_cell_size;
+		mutable Vector<CacheCell> m_cells;
+		mutable Vector<Color> m_cell_buffer;
+		mutable u64 m_cell_counter = 0;
 	};
 }
\ No newline at end of file
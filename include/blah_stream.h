@@ -4,6 +4,7 @@
 #include <blah_vector.h>
 #include <blah_calc.h>
 #include <blah_filesystem.h>
+#include <string.h> // for memcpy
 
 namespace Blah
 {
@@ -37,6 +38,10 @@ namespace Blah
 		// returns true of the stream is writable
 		virtual bool is_writable() const = 0;
 
+		// Returns the stream's contents if they're stored contiguously in memory, or nullptr if they aren't.
+		// Loaders use this to parse data in place (from `data() + position()`) instead of copying it out.
+		virtual const u8* data() const;
+
 		// pipes the contents of this stream to another stream
 		size_t pipe(Stream& to, size_t length);
 
@@ -85,15 +90,29 @@ namespace Blah
 
 		// writes the amount of bytes to the stream from the given buffer, and returns the amount written
 		virtual size_t write_data(const void* buffer, size_t length) = 0;
+
+		// Data that can be read without calling `read_data`.
+		// Buffered streams point this at their read-ahead buffer, so small reads are just a copy.
+		const u8* m_read_cursor = nullptr;
+		const u8* m_read_end = nullptr;
+
+	private:
+		template<class T>
+		T read_value(Endian endian);
 	};
 
-	// File Stream reads & writes over a File handle
-	class FileStream : public Stream
+	// Buffered Stream adds a read-ahead buffer and coalesced writes to another Stream.
+	// Writes are only guaranteed to reach the underlying Stream after `flush` is called,
+	// or the Buffered Stream is destroyed. The wrapped Stream must outlive the Buffered Stream,
+	// and shouldn't be used directly while it's wrapped, as its position will be ahead of this one.
+	class BufferedStream : public Stream
 	{
 	public:
-		FileStream() = default;
-		FileStream(const FilePath& path, FileMode mode);
-		FileStream(const FileRef& file);
+		static constexpr size_t default_buffer_size = 64 * 1024;
+
+		BufferedStream() = default;
+		BufferedStream(Stream& stream, size_t buffer_size = default_buffer_size);
+		~BufferedStream() override;
 
 		size_t length() const override;
 		size_t position() const override;
@@ -102,14 +121,95 @@ namespace Blah
 		bool is_readable() const override;
 		bool is_writable() const override;
 
+		// writes any buffered data to the underlying stream, returning false if it couldn't all be written
+		bool flush();
+
+		// sets the size of the buffer. a size of 0 disables buffering.
+		void set_buffer_size(size_t buffer_size);
+		size_t buffer_size() const;
+
 	protected:
 		size_t read_data(void* ptr, size_t length) override;
 		size_t write_data(const void* ptr, size_t length) override;
 
+		// the unbuffered operations, which use the wrapped stream by default
+		virtual size_t unbuffered_length() const;
+		virtual size_t unbuffered_seek(size_t position);
+		virtual size_t unbuffered_read(void* ptr, size_t length);
+		virtual size_t unbuffered_write(const void* ptr, size_t length);
+
+	private:
+		bool alloc_buffer();
+		void drop_read_buffer();
+
+		Stream* m_stream = nullptr;
+		Vector<u8> m_buffer;
+		size_t m_buffer_size = default_buffer_size;
+
+		// position of the underlying stream at the start of the buffer
+		size_t m_origin = 0;
+
+		// amount of data waiting to be written
+		size_t m_write_length = 0;
+	};
+
+	// File Stream reads & writes over a File handle.
+	// It's buffered, so the File's position will be ahead of the stream while reading,
+	// and writes aren't guaranteed to reach the File until `flush` is called or the stream is destroyed.
+	class FileStream : public BufferedStream
+	{
+	public:
+		FileStream() = default;
+		FileStream(const FilePath& path, FileMode mode, size_t buffer_size = default_buffer_size);
+		FileStream(const FileRef& file, size_t buffer_size = default_buffer_size);
+		~FileStream() override;
+
+		bool is_open() const override;
+		bool is_readable() const override;
+		bool is_writable() const override;
+
+	protected:
+		size_t unbuffered_length() const override;
+		size_t unbuffered_seek(size_t position) override;
+		size_t unbuffered_read(void* ptr, size_t length) override;
+		size_t unbuffered_write(const void* ptr, size_t length) override;
+
 	private:
 		FileRef m_file;
 	};
 
+	// Mapped File Stream memory-maps a file for reading, so its contents can be accessed
+	// through `data()` without being copied. If the file can't be mapped, it's read into memory instead.
+	class MappedFileStream : public Stream
+	{
+	public:
+		MappedFileStream() = default;
+		MappedFileStream(const FilePath& path);
+		~MappedFileStream() override;
+
+		size_t length() const override;
+		size_t position() const override;
+		size_t seek(size_t position) override;
+		bool is_open() const override;
+		bool is_readable() const override;
+		bool is_writable() const override;
+		const u8* data() const override;
+
+		// whether the file is memory-mapped, rather than read into memory
+		bool is_mapped() const;
+
+	protected:
+		size_t read_data(void* ptr, size_t length) override;
+		size_t write_data(const void* ptr, size_t length) override;
+
+	private:
+		Vector<u8> m_buffer;
+		const u8* m_data = nullptr;
+		size_t m_length = 0;
+		bool m_open = false;
+		bool m_mapped = false;
+	};
+
 	// Memory Stream moves over an existing buffer.
 	// The Buffer must exist for the duration of the Memory Stream.
 	class MemoryStream : public Stream
@@ -127,7 +227,7 @@ namespace Blah
 		bool is_writable() const override;
 
 		u8* data();
-		const u8* data() const;
+		const u8* data() const override;
 
 	protected:
 		size_t read_data(void* ptr, size_t length) override;
@@ -146,7 +246,7 @@ namespace Blah
 	{
 	public:
 		BufferStream() = default;
-		BufferStream(int capacity);
+		BufferStream(size_t length);
 
 		size_t length() const override;
 		size_t position() const override;
@@ -158,7 +258,7 @@ namespace Blah
 		void resize(size_t length);
 		void clear();
 		u8* data();
-		const u8* data() const;
+		const u8* data() const override;
 
 	protected:
 		size_t read_data(void* ptr, size_t length) override;
@@ -168,4 +268,35 @@ namespace Blah
 		Vector<u8> m_buffer;
 		size_t m_position = 0;
 	};
+
+	inline size_t Stream::read(void* buffer, size_t length)
+	{
+		if (length > 0 && length <= (size_t)(m_read_end - m_read_cursor))
+		{
+			memcpy(buffer, m_read_cursor, length);
+			m_read_cursor += length;
+			return length;
+		}
+
+		return read_data(buffer, length);
+	}
+
+	template<class T>
+	inline T Stream::read_value(Endian endian)
+	{
+		T value; read(&value, sizeof(T));
+		if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
+		return value;
+	}
+
+	inline u8  Stream::read_u8 (Endian endian) { return read_value<u8> (endian); }
+	inline u16 Stream::read_u16(Endian endian) { return read_value<u16>(endian); }
+	inline u32 Stream::read_u32(Endian endian) { return read_value<u32>(endian); }
+	inline u64 Stream::read_u64(Endian endian) { return read_value<u64>(endian); }
+	inline i8  Stream::read_i8 (Endian endian) { return read_value<i8> (endian); }
+	inline i16 Stream::read_i16(Endian endian) { return read_value<i16>(endian); }
+	inline i32 Stream::read_i32(Endian endian) { return read_value<i32>(endian); }
+	inline i64 Stream::read_i64(Endian endian) { return read_value<i64>(endian); }
+	inline f32 Stream::read_f32(Endian endian) { return read_value<f32>(endian); }
+	inline f64 Stream::read_f64(Endian endian) { return read_value<f64>(endian); }
 }
\ No newline at end of file
@@ -51,12 +51,19 @@ namespace Blah
 		}
 
 		bool equals(const char* other, bool ignore_case = false) const;
+		bool equals(const BaseString& other) const;
 		bool empty() const { return length() == 0; }
 		void clear() { s_clear(); }
 
+		// hashes the string's characters
+		u32 hash() const { return hash(cstr(), length()); }
+
+		// hashes the characters, a word at a time
+		static u32 hash(const char* cstr, int length);
+
 		bool operator==(const char* rhs) const { return equals(rhs); }
 		bool operator!=(const char* rhs) const { return !(*this == rhs); }
-		bool operator==(const BaseString& rhs) const { return s_len() == rhs.s_len() && *this == rhs.cstr(); }
+		bool operator==(const BaseString& rhs) const { return equals(rhs); }
 		bool operator!=(const BaseString& rhs) const { return !(*this == rhs); }
 
 	protected:
@@ -223,6 +230,8 @@ namespace Blah
 			if (count <= 0)
 				return;
 
+			Memory::TagScope tag(Memory::Tag::String);
+
 			// expand heap buffer
 			if (m_heap_buffer.size() > 0)
 			{
@@ -358,15 +367,7 @@ namespace std
 	{
 		std::size_t operator()(const Blah::BaseString& key) const
 		{
-			std::size_t result = 2166136261U;
-
-			for (auto& it : key)
-			{
-				result ^= static_cast<std::size_t>(it);
-				result *= 16777619U;
-			}
-
-			return result;
+			return key.hash();
 		}
 	};
 
@@ -375,15 +376,7 @@ namespace std
 	{
 		std::size_t operator()(const Blah::StackString<StackSize>& key) const
 		{
-			std::size_t result = 2166136261U;
-
-			for (auto& it : key)
-			{
-				result ^= static_cast<std::size_t>(it);
-				result *= 16777619U;
-			}
-
-			return result;
+			return key.hash();
 		}
 	};
 }
@@ -0,0 +1,61 @@
+#pragma once
+#include <blah_common.h>
+#include <blah_string.h>
+
+namespace Blah
+{
+	// An interned, immutable string, for identifiers like uniform names, paths, or binding names.
+	// Every StringId with the same characters points to the same interned string, so comparing
+	// them is a single pointer comparison, and their hash is computed once when they're created.
+	// Interned strings are never freed, so StringIds shouldn't be made from arbitrary or unbounded text.
+	class StringId
+	{
+	private:
+		struct Entry
+		{
+			const char* str;
+			int length;
+			u32 hash;
+		};
+
+		static const Entry s_empty;
+		const Entry* m_entry = &s_empty;
+
+		static const Entry* intern(const char* cstr, int length);
+
+	public:
+		StringId() = default;
+		StringId(const char* cstr);
+		StringId(const char* cstr, const char* cstr_end);
+		explicit StringId(const BaseString& str);
+
+		const char* cstr() const { return m_entry->str; }
+		int length() const { return m_entry->length; }
+		bool empty() const { return m_entry->length == 0; }
+
+		// the hash of the string, which is the same as `BaseString::hash` for the same characters
+		u32 hash() const { return m_entry->hash; }
+
+		operator const char* () const { return cstr(); }
+
+		bool operator==(const StringId& rhs) const { return m_entry == rhs.m_entry; }
+		bool operator!=(const StringId& rhs) const { return m_entry != rhs.m_entry; }
+		bool operator==(const char* rhs) const;
+		bool operator!=(const char* rhs) const { return !(*this == rhs); }
+
+		// number of strings that have been interned
+		static int interned_count();
+	};
+}
+
+namespace std
+{
+	template <>
+	struct hash<Blah::StringId>
+	{
+		std::size_t operator()(const Blah::StringId& key) const
+		{
+			return key.hash();
+		}
+	};
+}
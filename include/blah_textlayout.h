@@ -0,0 +1,73 @@
+#pragma once
+#include <blah_common.h>
+#include <blah_string.h>
+#include <blah_vector.h>
+#include <blah_spatial.h>
+#include <blah_subtexture.h>
+#include <blah_spritefont.h>
+
+namespace Blah
+{
+	// A string that has been laid out with a SpriteFont. The text is decoded, measured,
+	// and each glyph is positioned once, so it can be drawn repeatedly with `Batch::str`.
+	// The layout keeps the Subtextures of its glyphs, so it should be rebuilt if the
+	// SpriteFont changes (or, for dynamic SpriteFonts, if its glyphs may have been evicted).
+	class TextLayout
+	{
+	public:
+
+		// A single drawable glyph
+		struct Glyph
+		{
+			// the glyph's codepoint
+			SpriteFont::Codepoint codepoint = 0;
+
+			// the glyph's texture
+			Subtexture subtexture;
+
+			// position to draw the glyph at, relative to the layout's origin
+			Vec2f position;
+
+			// the line the glyph is on
+			int line = 0;
+		};
+
+		// A single line of text
+		struct Line
+		{
+			// index of the first glyph in the line
+			int glyph_start = 0;
+
+			// number of glyphs in the line
+			int glyph_count = 0;
+
+			// bounds of the line, relative to the layout's origin
+			Rectf bounds;
+		};
+
+		// drawable glyphs (characters without an image, like spaces, are skipped)
+		Vector<Glyph> glyphs;
+
+		// the lines of text
+		Vector<Line> lines;
+
+		// bounds of the text, relative to the layout's origin
+		Rectf bounds;
+
+		// the SDF spread of the font, if it was a signed distance field SpriteFont
+		int sdf_spread = 0;
+
+		TextLayout() = default;
+		TextLayout(const SpriteFont& font, const String& text);
+		TextLayout(const SpriteFont& font, const String& text, const Vec2f& justify, float max_width = 0);
+
+		// Lays out the text with the given font.
+		// `justify` aligns the text around the origin, the same as `Batch::str` (ex. 0.5,0.5 centers it).
+		// If `max_width` is larger than 0, lines are wrapped at spaces so they fit within it.
+		// Words wider than `max_width` are broken between characters.
+		void build(const SpriteFont& font, const String& text, const Vec2f& justify = Vec2f::zero, float max_width = 0);
+
+		// clears the layout
+		void clear();
+	};
+}
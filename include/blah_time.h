@@ -26,6 +26,10 @@ namespace Blah
 		// time the application should pause for
 		extern float pause_timer;
 
+		// number of frames that have been rendered. unlike `ticks`, this only
+		// advances once per rendered frame, even with multiple fixed timestep updates
+		extern u64 frames;
+
 		// uptime, in ticks. polls the Platform for an immediate value, unlike the cached `Time::ticks` value
 		u64 get_ticks();
 
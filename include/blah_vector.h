@@ -1,5 +1,8 @@
 #pragma once
 #include <blah_common.h>
+#include <blah_memory.h>
+#include <type_traits> // for trivially copyable fast paths
+#include <string.h>    // for memcpy, memmove
 
 namespace Blah
 {
@@ -9,13 +12,18 @@ namespace Blah
 	{
 	private:
 		T* m_buffer;
-		int m_count;
-		int m_capacity;
+		i64 m_count;
+		i64 m_capacity;
+
+		void copy_from(const Vector& src);
 
 	public:
 
+		// the largest number of elements a Vector can hold
+		static constexpr i64 max_capacity = (i64)((SIZE_MAX / 2) / sizeof(T));
+
 		Vector();
-		Vector(int capacity);
+		Vector(i64 capacity);
 		Vector(const InitializerList<T>& list);
 		Vector(const Vector& src);
 		Vector(Vector&& src) noexcept;
@@ -27,20 +35,29 @@ namespace Blah
 		void clear();
 		void dispose();
 
-		int size() const;
-		int capacity() const;
+		i64 size() const;
+		i64 capacity() const;
+
+		// Reserves space for at least `new_capacity` elements.
+		// If the capacity is too large or can't be allocated, an error is logged and the Vector is left unchanged.
+		void reserve(i64 new_capacity);
+		void resize(i64 new_count);
 
-		void reserve(int new_capacity);
-		void resize(int new_count);
-		T* expand(int amount = 1);
+		// Adds default-constructed elements to the end of the Vector, and returns a pointer to the first one.
+		// Returns null if the Vector can't grow by that amount.
+		T* expand(i64 amount = 1);
+
+		// Adds elements to the end of the Vector without constructing them, and returns a pointer to the first one.
+		// Only available for trivial types, and the caller must write every element before reading it.
+		T* expand_uninitialized(i64 amount = 1);
 
 		void push_back(const T& item);
 		void push_back(T&& item);
 		template<class ...Args>
 		void emplace_back(Args&&...args);
 
-		T& operator[](int index);
-		const T& operator[](int index) const;
+		T& operator[](i64 index);
+		const T& operator[](i64 index) const;
 
 		T* data();
 		const T* data() const;
@@ -53,7 +70,7 @@ namespace Blah
 		T& back();
 		const T& back() const;
 
-		void erase(int index, int elements = 1);
+		void erase(i64 index, i64 elements = 1);
 		T pop();
 	};
 
@@ -66,7 +83,7 @@ namespace Blah
 	}
 
 	template<class T>
-	inline Vector<T>::Vector(int capacity)
+	inline Vector<T>::Vector(i64 capacity)
 	{
 		m_buffer = nullptr;
 		m_count = m_capacity = 0;
@@ -79,9 +96,7 @@ namespace Blah
 		m_buffer = nullptr;
 		m_count = m_capacity = 0;
 		reserve(src.m_capacity);
-		for (int i = 0; i < src.m_count; i++)
-			new (m_buffer + i) T(src.m_buffer[i]);
-		m_count = src.m_count;
+		copy_from(src);
 	}
 
 	template<class T>
@@ -100,7 +115,7 @@ namespace Blah
 	{
 		m_buffer = nullptr;
 		m_count = m_capacity = 0;
-		reserve((int)list.size());
+		reserve((i64)list.size());
 		for (auto& it : list)
 			push_back(std::move(it));
 	}
@@ -116,9 +131,7 @@ namespace Blah
 	{
 		clear();
 		reserve(src.m_capacity);
-		for (int i = 0; i < src.m_count; i++)
-			new (m_buffer + i) T(src.m_buffer[i]);
-		m_count = src.m_count;
+		copy_from(src);
 		return *this;
 	}
 
@@ -135,11 +148,32 @@ namespace Blah
 		return *this;
 	}
 
+	template<class T>
+	inline void Vector<T>::copy_from(const Vector& src)
+	{
+		if constexpr (std::is_trivially_copyable<T>())
+		{
+			if (src.m_count > 0)
+				memcpy(m_buffer, src.m_buffer, sizeof(T) * src.m_count);
+		}
+		else
+		{
+			for (i64 i = 0; i < src.m_count; i++)
+				new (m_buffer + i) T(src.m_buffer[i]);
+		}
+
+		m_count = src.m_count;
+	}
+
 	template<class T>
 	inline void Vector<T>::clear()
 	{
-		for (int i = 0; i < m_count; i++)
-			m_buffer[i].~T();
+		if constexpr (!std::is_trivially_destructible<T>())
+		{
+			for (i64 i = 0; i < m_count; i++)
+				m_buffer[i].~T();
+		}
+
 		m_count = 0;
 	}
 
@@ -148,63 +182,86 @@ namespace Blah
 	{
 		clear();
 
-		::operator delete[] (m_buffer);
+		Memory::free(m_buffer);
 
 		m_capacity = 0;
 		m_buffer = nullptr;
 	}
 
 	template<class T>
-	inline int Vector<T>::size() const
+	inline i64 Vector<T>::size() const
 	{
 		return m_count;
 	}
 
 	template<class T>
-	inline int Vector<T>::capacity() const
+	inline i64 Vector<T>::capacity() const
 	{
 		return m_capacity;
 	}
 
 	template<class T>
-	inline void Vector<T>::reserve(int cap)
+	inline void Vector<T>::reserve(i64 cap)
 	{
 		if (cap > m_capacity)
 		{
-			int new_capacity = m_capacity;
+			if (cap > max_capacity)
+			{
+				BLAH_ASSERT(false, "Vector capacity is too large");
+				Log::error("Vector capacity of %lld is too large", (long long)cap);
+				return;
+			}
+
+			i64 new_capacity = m_capacity;
 			if (new_capacity <= 0)
 				new_capacity = 8;
 			while (new_capacity < cap)
-				new_capacity *= 2;
+				new_capacity = (new_capacity > max_capacity / 2 ? max_capacity : new_capacity * 2);
 
-			T* new_buffer = (T*)::operator new[] (sizeof(T) * new_capacity);
+			size_t bytes = sizeof(T) * (size_t)new_capacity;
 
+			// trivially copyable types can be moved in memory, so the buffer can be grown in-place
 			if constexpr (std::is_trivially_copyable<T>())
 			{
-				u8* src = (u8*)m_buffer;
-				u8* len = src + m_count * sizeof(T);
-				u8* dst = (u8*)new_buffer;
-				while (src < len) *(dst++) = *(src++);
+				T* new_buffer;
+				if (m_buffer == nullptr)
+					new_buffer = (T*)Memory::alloc(bytes, alignof(T));
+				else
+					new_buffer = (T*)Memory::realloc(m_buffer, bytes);
+
+				if (new_buffer == nullptr)
+				{
+					Log::error("Failed to allocate %zu bytes for a Vector", bytes);
+					return;
+				}
+
+				m_buffer = new_buffer;
 			}
 			else
 			{
-				for (int i = 0; i < m_count; i++)
+				T* new_buffer = (T*)Memory::alloc(bytes, alignof(T));
+				if (new_buffer == nullptr)
 				{
-					if (i < new_capacity)
-						new (new_buffer + i) T(std::move(m_buffer[i]));
+					Log::error("Failed to allocate %zu bytes for a Vector", bytes);
+					return;
+				}
+
+				for (i64 i = 0; i < m_count; i++)
+				{
+					new (new_buffer + i) T(std::move(m_buffer[i]));
 					m_buffer[i].~T();
 				}
-			}
 
-			::operator delete[] (m_buffer);
+				Memory::free(m_buffer);
+				m_buffer = new_buffer;
+			}
 
-			m_buffer = new_buffer;
 			m_capacity = new_capacity;
 		}
 	}
 
 	template<class T>
-	inline void Vector<T>::resize(int new_count)
+	inline void Vector<T>::resize(i64 new_count)
 	{
 		if (new_count < m_count)
 			erase(new_count, m_count - new_count);
@@ -213,14 +270,23 @@ namespace Blah
 	}
 
 	template<class T>
-	inline T* Vector<T>::expand(int amount)
+	inline T* Vector<T>::expand(i64 amount)
 	{
 		if (amount > 0)
 		{
-			int count = m_count;
+			i64 count = m_count;
+
+			if (amount > max_capacity - count)
+			{
+				BLAH_ASSERT(false, "Vector capacity is too large");
+				return nullptr;
+			}
 
 			reserve(count + amount);
-			for (int i = 0; i < amount; i++)
+			if (m_capacity < count + amount)
+				return nullptr;
+
+			for (i64 i = 0; i < amount; i++)
 				new (m_buffer + count + i) T();
 
 			m_count += amount;
@@ -230,10 +296,42 @@ namespace Blah
 		return m_buffer;
 	}
 
+	template<class T>
+	inline T* Vector<T>::expand_uninitialized(i64 amount)
+	{
+		static_assert(std::is_trivially_copyable<T>() && std::is_trivially_destructible<T>(), "expand_uninitialized requires a trivial type");
+
+		if (amount > 0)
+		{
+			i64 count = m_count;
+
+			if (amount > max_capacity - count)
+			{
+				BLAH_ASSERT(false, "Vector capacity is too large");
+				return nullptr;
+			}
+
+			reserve(count + amount);
+			if (m_capacity < count + amount)
+				return nullptr;
+
+			m_count += amount;
+			return &m_buffer[count];
+		}
+
+		return m_buffer;
+	}
+
 	template<class T>
 	inline void Vector<T>::push_back(const T& item)
 	{
-		reserve(m_count + 1);
+		if (m_count >= m_capacity)
+		{
+			reserve(m_count + 1);
+			if (m_count >= m_capacity)
+				return;
+		}
+
 		new (m_buffer + m_count) T(item);
 		m_count++;
 	}
@@ -241,7 +339,13 @@ namespace Blah
 	template<class T>
 	inline void Vector<T>::push_back(T&& item)
 	{
-		reserve(m_count + 1);
+		if (m_count >= m_capacity)
+		{
+			reserve(m_count + 1);
+			if (m_count >= m_capacity)
+				return;
+		}
+
 		new (m_buffer + m_count) T(std::move(item));
 		m_count++;
 	}
@@ -250,20 +354,26 @@ namespace Blah
 	template<class ...Args>
 	inline void Vector<T>::emplace_back(Args&& ...args)
 	{
-		reserve(m_count + 1);
+		if (m_count >= m_capacity)
+		{
+			reserve(m_count + 1);
+			if (m_count >= m_capacity)
+				return;
+		}
+
 		new (m_buffer + m_count) T(std::forward<Args>(args)...);
 		m_count++;
 	}
 
 	template<class T>
-	inline T& Vector<T>::operator[](int index)
+	inline T& Vector<T>::operator[](i64 index)
 	{
 		BLAH_ASSERT(index >= 0 && index < m_count, "Index out of range");
 		return m_buffer[index];
 	}
 
 	template<class T>
-	inline const T& Vector<T>::operator[](int index) const
+	inline const T& Vector<T>::operator[](i64 index) const
 	{
 		BLAH_ASSERT(index >= 0 && index < m_count, "Index out of range");
 		return m_buffer[index];
@@ -334,16 +444,24 @@ namespace Blah
 	}
 
 	template<class T>
-	inline void Vector<T>::erase(int index, int elements)
+	inline void Vector<T>::erase(i64 index, i64 elements)
 	{
-		BLAH_ASSERT(index >= 0 && index + elements <= m_count, "Index out of range");
+		BLAH_ASSERT(index >= 0 && elements >= 0 && elements <= m_count - index, "Index out of range");
 
 		if (elements >= 1)
 		{
-			for (int i = index; i < (m_count - elements); i++)
-				m_buffer[i] = std::move(m_buffer[i + elements]);
-			for (int i = m_count - elements; i < m_count; i++)
-				m_buffer[i].~T();
+			if constexpr (std::is_trivially_copyable<T>())
+			{
+				memmove(m_buffer + index, m_buffer + index + elements, sizeof(T) * (m_count - index - elements));
+			}
+			else
+			{
+				for (i64 i = index; i < (m_count - elements); i++)
+					m_buffer[i] = std::move(m_buffer[i + elements]);
+				for (i64 i = m_count - elements; i < m_count; i++)
+					m_buffer[i].~T();
+			}
+
 			m_count -= elements;
 		}
 	}
@@ -1,6 +1,7 @@
 #include <blah_app.h>
 #include <blah_common.h>
 #include <blah_time.h>
+#include <blah_framearena.h>
 #include "internal/blah_internal.h"
 #include "internal/blah_platform.h"
 #include "internal/blah_renderer.h"
@@ -187,6 +188,9 @@ void Internal::app_step()
 			app_config.on_update();
 	};
 
+	// Dispatch finished async file requests
+	Internal::file_update();
+
 	bool is_fixed_timestep = App::get_flag(Flags::FixedTimestep);
 
 	// Update in Fixed Timestep
@@ -277,11 +281,17 @@ void Internal::app_step()
 	// Update audio
 	if (app_is_audio_running)
 		Blah::Internal::audio_update();
+
+	// Release this frame's temporary allocations
+	FrameArena::reset();
+	Time::frames++;
 }
 
 void Internal::app_shutdown()
 {
 	// shutdown systems
+	Internal::image_shutdown();
+	Internal::file_shutdown();
 	Internal::input_shutdown();
 	if (app_renderer_api)
 	{
@@ -291,6 +301,7 @@ void Internal::app_shutdown()
 	}
 	set_audio_system(false);
 	Platform::shutdown();
+	FrameArena::dispose();
 
 	// clear static App state
 	app_config = Config();
@@ -306,6 +317,7 @@ void Internal::app_shutdown()
 	Time::previous_ticks = 0;
 	Time::previous_seconds = 0;
 	Time::delta = 0;
+	Time::frames = 0;
 }
 
 Renderer* Internal::app_renderer()
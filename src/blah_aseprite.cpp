@@ -1,25 +1,74 @@
 #include <blah_aseprite.h>
 #include <blah_filesystem.h>
 #include <blah_calc.h>
+#include "internal/blah_parallel.h"
 
 #define STBI_NO_STDIO
 #define STBI_ONLY_ZLIB
 #include "third_party/stb_image.h"
 
+// the Normal blend mode is composited 4 pixels at a time where SSE2 or NEON is available.
+// both paths assume Color is laid out as RGBA in a little-endian u32.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLAH_ASEPRITE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__) && !defined(__ARM_BIG_ENDIAN)
+#define BLAH_ASEPRITE_NEON
+#include <arm_neon.h>
+#endif
+
 using namespace Blah;
 
-Aseprite::Aseprite(const FilePath& path)
+Aseprite::Aseprite(const FilePath& path, LoadModes load_mode, int thread_count)
+	: load_mode(load_mode)
 {
-	FileStream fs(path, FileMode::OpenRead);
-	parse(fs);
+	MappedFileStream fs(path);
+	parse(fs, thread_count);
 }
 
-Aseprite::Aseprite(Stream& stream)
+Aseprite::Aseprite(Stream& stream, LoadModes load_mode, int thread_count)
+	: load_mode(load_mode)
 {
-	parse(stream);
+	parse(stream, thread_count);
 }
 
-void Aseprite::parse(Stream& stream)
+const Image& Aseprite::get_frame_image(int index)
+{
+	static const Image empty;
+
+	BLAH_ASSERT(index >= 0 && index < frames.size(), "Frame index out of range");
+	if (index < 0 || index >= frames.size() || load_mode == LoadModes::MetadataOnly)
+		return empty;
+
+	Frame& frame = frames[index];
+
+	if (load_mode == LoadModes::Lazy)
+	{
+		// move the frame to the back of the cache, as it's the most recently used
+		for (int i = 0; i < m_cached_frames.size(); i++)
+			if (m_cached_frames[i] == index)
+			{
+				m_cached_frames.erase(i);
+				break;
+			}
+
+		if (frame.image.pixels == nullptr)
+			render_frame(&frame);
+
+		m_cached_frames.push_back(index);
+
+		// dispose the least recently used frame images
+		while (max_cached_frames > 0 && m_cached_frames.size() > max_cached_frames)
+		{
+			frames[m_cached_frames[0]].image.dispose();
+			m_cached_frames.erase(0);
+		}
+	}
+
+	return frame.image;
+}
+
+void Aseprite::parse(Stream& stream, int thread_count)
 {
 	if (!stream.is_readable())
 	{
@@ -63,6 +112,11 @@ void Aseprite::parse(Stream& stream)
 
 	frames.resize(frame_count);
 
+	// When using multiple threads, the file is read once on this thread and the
+	// compressed cel data is stored. Afterwards the cels are inflated and the frames
+	// are composited in parallel, since each one is independent of the others.
+	m_deferred = (Internal::thread_count(thread_count) > 1 && load_mode != LoadModes::MetadataOnly);
+
 	// frames
 	for (int i = 0; i < frame_count; i++)
 	{
@@ -91,7 +145,9 @@ void Aseprite::parse(Stream& stream)
 		}
 
 		// make frame image
-		frames[i].image = Image(width, height);
+		// (deferred frames are allocated when they're composited)
+		if (load_mode == LoadModes::Full && !m_deferred)
+			frames[i].image = Image(width, height);
 
 		// frame chunks
 		for (unsigned int j = 0; j < chunks; j++)
@@ -116,6 +172,29 @@ void Aseprite::parse(Stream& stream)
 
 		stream.seek(frameEnd);
 	}
+
+	if (m_deferred)
+	{
+		Internal::parallel_for(m_deferred_cels.size(), thread_count, [this](int i)
+		{
+			auto& it = m_deferred_cels[i];
+			auto& cel = frames[it.frame].cels[it.cel];
+
+			decode_cel(&cel, it.compressed, it.compressed_size);
+		});
+
+		m_deferred_cels.dispose();
+		m_deferred = false;
+
+		// linked cels only ever read from other frames, so each frame can be composited separately
+		if (load_mode == LoadModes::Full)
+		{
+			Internal::parallel_for(frames.size(), thread_count, [this](int i)
+			{
+				render_frame(&frames[i]);
+			});
+		}
+	}
 }
 
 void Aseprite::parse_layer(Stream& stream, int frame)
@@ -157,7 +236,8 @@ void Aseprite::parse_cel(Stream& stream, int frameIndex, size_t maxPosition)
 	stream.seek(stream.position() + 7);
 
 	// RAW or DEFLATE
-	if (celType == 0 || celType == 2)
+	// pixel data is skipped entirely when we only want the metadata
+	if ((celType == 0 || celType == 2) && load_mode != LoadModes::MetadataOnly)
 	{
 		auto width = stream.read_u16(Endian::Little);
 		auto height = stream.read_u16(Endian::Little);
@@ -169,48 +249,70 @@ void Aseprite::parse_cel(Stream& stream, int frameIndex, size_t maxPosition)
 		if (celType == 0)
 		{
 			stream.read(cel.image.pixels, count);
+
+			if (m_deferred)
+			{
+				m_deferred_cels.emplace_back();
+				m_deferred_cels.back().frame = frameIndex;
+				m_deferred_cels.back().cel = frame.cels.size() - 1;
+			}
+			else
+				decode_cel(&cel, nullptr, 0);
 		}
 		// DEFLATE (zlib)
 		else
 		{
-			// this could be optimized to use a buffer on the stack if we only read set chunks at a time
-			// stbi's zlib doesn't have that functionality though
-			auto size = maxPosition - stream.position();
+			// the chunk size comes from the file, so make sure it doesn't run past the end of the stream
+			auto position = stream.position();
+			auto end = Calc::min(maxPosition, stream.length());
+			if (end <= position)
+			{
+				BLAH_ASSERT(false, "Unable to parse Aseprite file");
+				return;
+			}
+
+			auto size = end - position;
 			if (size > INT32_MAX)
 				size = INT32_MAX;
 
-			char* buffer = new char[size];
-			stream.read(buffer, size);
+			// if the stream's contents are in memory, the cel is inflated straight from them.
+			// parse() finishes decoding before it returns, so the data is valid until then.
+			const u8* compressed = stream.data();
+			if (compressed != nullptr)
+				compressed += position;
 
-			int olen = width * height * sizeof(Color);
-			int res = stbi_zlib_decode_buffer((char*)cel.image.pixels, olen, buffer, (int)size);
+			if (m_deferred)
+			{
+				m_deferred_cels.emplace_back();
 
-			delete[] buffer;
+				auto& it = m_deferred_cels.back();
+				it.frame = frameIndex;
+				it.cel = frame.cels.size() - 1;
+				it.compressed_size = size;
 
-			if (res < 0)
-			{
-				BLAH_ASSERT(false, "Unable to parse Aseprite file");
-				return;
+				if (compressed == nullptr)
+				{
+					it.buffer.resize((i64)size);
+					stream.read(it.buffer.data(), size);
+					compressed = it.buffer.data();
+				}
+
+				it.compressed = compressed;
 			}
-		}
+			else
+			{
+				Vector<u8> buffer;
+				if (compressed == nullptr)
+				{
+					buffer.resize((i64)size);
+					stream.read(buffer.data(), size);
+					compressed = buffer.data();
+				}
 
-		// convert to pixels
-		// note: we work in-place to save having to store stuff in a buffer
-		if (mode == Modes::Grayscale)
-		{
-			auto src = (unsigned char*)cel.image.pixels;
-			auto dst = cel.image.pixels;
-			for (int d = width * height - 1, s = (width * height - 1) * 2; d >= 0; d--, s -= 2)
-				dst[d] = Color(src[s], src[s], src[s], src[s + 1]);
-		}
-		else if (mode == Modes::Indexed)
-		{
-			auto src = (unsigned char*)cel.image.pixels;
-			auto dst = cel.image.pixels;
-			for (int i = width * height - 1; i >= 0; i--)
-				dst[i] = palette[src[i]];
+				if (!decode_cel(&cel, compressed, size))
+					return;
+			}
 		}
-
 	}
 	// REFERENCE
 	// this cel directly references a previous cel
@@ -220,7 +322,8 @@ void Aseprite::parse_cel(Stream& stream, int frameIndex, size_t maxPosition)
 	}
 
 	// draw to frame if visible
-	if ((int)layers[cel.layer_index].flag & (int)LayerFlags::Visible)
+	// (lazy and deferred frames are composited later)
+	if (load_mode == LoadModes::Full && !m_deferred && ((int)layers[cel.layer_index].flag & (int)LayerFlags::Visible))
 	{
 		render_cel(&cel, &frame);
 	}
@@ -230,6 +333,44 @@ void Aseprite::parse_cel(Stream& stream, int frameIndex, size_t maxPosition)
 	m_last_userdata = &(cel.userdata);
 }
 
+bool Aseprite::decode_cel(Cel* cel, const u8* compressed, size_t compressed_size) const
+{
+	auto width = cel->image.width;
+	auto height = cel->image.height;
+
+	// DEFLATE (zlib)
+	if (compressed != nullptr)
+	{
+		int olen = width * height * sizeof(Color);
+		int res = stbi_zlib_decode_buffer((char*)cel->image.pixels, olen, (const char*)compressed, (int)compressed_size);
+
+		if (res < 0)
+		{
+			BLAH_ASSERT(false, "Unable to parse Aseprite file");
+			return false;
+		}
+	}
+
+	// convert to pixels
+	// note: we work in-place to save having to store stuff in a buffer
+	if (mode == Modes::Grayscale)
+	{
+		auto src = (unsigned char*)cel->image.pixels;
+		auto dst = cel->image.pixels;
+		for (int d = width * height - 1, s = (width * height - 1) * 2; d >= 0; d--, s -= 2)
+			dst[d] = Color(src[s], src[s], src[s], src[s + 1]);
+	}
+	else if (mode == Modes::Indexed)
+	{
+		auto src = (unsigned char*)cel->image.pixels;
+		auto dst = cel->image.pixels;
+		for (int i = width * height - 1; i >= 0; i--)
+			dst[i] = palette[src[i]];
+	}
+
+	return true;
+}
+
 void Aseprite::parse_palette(Stream& stream, int frame)
 {
 	/* size */ stream.read_u32(Endian::Little);
@@ -340,9 +481,351 @@ void Aseprite::parse_slice(Stream& stream, int frame)
 	}
 }
 
+void Aseprite::render_frame(Frame* frame)
+{
+	frame->image = Image(width, height);
+
+	for (auto& cel : frame->cels)
+		if ((int)layers[cel.layer_index].flag & (int)LayerFlags::Visible)
+			render_cel(&cel, frame);
+}
+
 #define MUL_UN8(a, b, t) \
 	((t) = (a) * (u16)(b) + 0x80, ((((t) >> 8) + (t) ) >> 8))
 
+#define DIV_UN8(a, b, t) \
+	((t) = (a) * 0xff + ((b) / 2), ((t) / (b)))
+
+namespace
+{
+	// Blend mode implementations, matching the ones in Aseprite's own source code
+	// (src/doc/blend_funcs.cpp). Each one takes the backdrop and source colors and
+	// returns the blended RGB, which is then composited with the Normal mode.
+	using BlendFn = Color(*)(Color backdrop, Color src);
+
+	int blend_multiply(int b, int s) { int t; return MUL_UN8(b, s, t); }
+	int blend_screen(int b, int s) { int t; return b + s - MUL_UN8(b, s, t); }
+	int blend_hard_light(int b, int s) { return s < 128 ? blend_multiply(b, s << 1) : blend_screen(b, (s << 1) - 255); }
+	int blend_overlay(int b, int s) { return blend_hard_light(s, b); }
+	int blend_darken(int b, int s) { return Calc::min(b, s); }
+	int blend_lighten(int b, int s) { return Calc::max(b, s); }
+	int blend_difference(int b, int s) { return Calc::abs(b - s); }
+	int blend_exclusion(int b, int s) { int t; t = MUL_UN8(b, s, t); return b + s - 2 * t; }
+	int blend_addition(int b, int s) { return Calc::min(b + s, 255); }
+	int blend_subtract(int b, int s) { return Calc::max(b - s, 0); }
+
+	int blend_color_dodge(int b, int s)
+	{
+		int t;
+		if (b == 0) return 0;
+		s = 255 - s;
+		if (b >= s) return 255;
+		return DIV_UN8(b, s, t);
+	}
+
+	int blend_color_burn(int b, int s)
+	{
+		int t;
+		if (b == 255) return 255;
+		b = 255 - b;
+		if (b >= s) return 0;
+		return 255 - DIV_UN8(b, s, t);
+	}
+
+	int blend_divide(int b, int s)
+	{
+		int t;
+		if (b == 0) return 0;
+		if (b >= s) return 255;
+		return DIV_UN8(b, s, t);
+	}
+
+	int blend_soft_light(int ib, int is)
+	{
+		double b = ib / 255.0;
+		double s = is / 255.0;
+		double d = (b <= 0.25 ? ((16 * b - 12) * b + 4) * b : sqrt(b));
+		double r = (s <= 0.5 ? b - (1.0 - 2.0 * s) * b * (1.0 - b) : b + (2.0 * s - 1.0) * (d - b));
+		return (int)(r * 255 + 0.5);
+	}
+
+	template<int(*Fn)(int, int)>
+	Color blend_separable(Color b, Color s)
+	{
+		return Color((u8)Fn(b.r, s.r), (u8)Fn(b.g, s.g), (u8)Fn(b.b, s.b), s.a);
+	}
+
+	// Non-separable blend modes work on the colors as a whole, in 0-1 space
+
+	struct RGBd
+	{
+		double r, g, b;
+
+		RGBd(Color c) : r(c.r / 255.0), g(c.g / 255.0), b(c.b / 255.0) {}
+
+		double lum() const { return 0.3 * r + 0.59 * g + 0.11 * b; }
+		double sat() const { return Calc::max(r, Calc::max(g, b)) - Calc::min(r, Calc::min(g, b)); }
+
+		void clip()
+		{
+			double l = lum();
+			double n = Calc::min(r, Calc::min(g, b));
+			double x = Calc::max(r, Calc::max(g, b));
+
+			if (n < 0)
+			{
+				r = l + (((r - l) * l) / (l - n));
+				g = l + (((g - l) * l) / (l - n));
+				b = l + (((b - l) * l) / (l - n));
+			}
+
+			if (x > 1)
+			{
+				r = l + (((r - l) * (1 - l)) / (x - l));
+				g = l + (((g - l) * (1 - l)) / (x - l));
+				b = l + (((b - l) * (1 - l)) / (x - l));
+			}
+		}
+
+		void set_lum(double l)
+		{
+			double d = l - lum();
+			r += d;
+			g += d;
+			b += d;
+			clip();
+		}
+
+		void set_sat(double s)
+		{
+			double* min = &r;
+			double* mid = &g;
+			double* max = &b;
+
+			if (*min > *mid) std::swap(min, mid);
+			if (*mid > *max) std::swap(mid, max);
+			if (*min > *mid) std::swap(min, mid);
+
+			if (*max > *min)
+			{
+				*mid = ((*mid - *min) * s) / (*max - *min);
+				*max = s;
+			}
+			else
+			{
+				*mid = *max = 0;
+			}
+
+			*min = 0;
+		}
+
+		Color to_color(u8 alpha) const
+		{
+			return Color(
+				(u8)Calc::clamp((int)(r * 255.0), 0, 255),
+				(u8)Calc::clamp((int)(g * 255.0), 0, 255),
+				(u8)Calc::clamp((int)(b * 255.0), 0, 255),
+				alpha);
+		}
+	};
+
+	Color blend_hue(Color backdrop, Color src)
+	{
+		RGBd b(backdrop), s(src);
+		double sat = b.sat();
+		double lum = b.lum();
+		s.set_sat(sat);
+		s.set_lum(lum);
+		return s.to_color(src.a);
+	}
+
+	Color blend_saturation(Color backdrop, Color src)
+	{
+		RGBd b(backdrop), s(src);
+		double lum = b.lum();
+		b.set_sat(s.sat());
+		b.set_lum(lum);
+		return b.to_color(src.a);
+	}
+
+	Color blend_color(Color backdrop, Color src)
+	{
+		RGBd b(backdrop), s(src);
+		s.set_lum(b.lum());
+		return s.to_color(src.a);
+	}
+
+	Color blend_luminosity(Color backdrop, Color src)
+	{
+		RGBd b(backdrop), s(src);
+		b.set_lum(s.lum());
+		return b.to_color(src.a);
+	}
+
+	BlendFn get_blend_fn(Aseprite::BlendModes mode)
+	{
+		using Modes = Aseprite::BlendModes;
+
+		switch (mode)
+		{
+		case Modes::Normal: return nullptr;
+		case Modes::Multiply: return blend_separable<blend_multiply>;
+		case Modes::Screen: return blend_separable<blend_screen>;
+		case Modes::Overlay: return blend_separable<blend_overlay>;
+		case Modes::Darken: return blend_separable<blend_darken>;
+		case Modes::Lighten: return blend_separable<blend_lighten>;
+		case Modes::ColorDodge: return blend_separable<blend_color_dodge>;
+		case Modes::ColorBurn: return blend_separable<blend_color_burn>;
+		case Modes::HardLight: return blend_separable<blend_hard_light>;
+		case Modes::SoftLight: return blend_separable<blend_soft_light>;
+		case Modes::Difference: return blend_separable<blend_difference>;
+		case Modes::Exclusion: return blend_separable<blend_exclusion>;
+		case Modes::Hue: return blend_hue;
+		case Modes::Saturation: return blend_saturation;
+		case Modes::Color: return blend_color;
+		case Modes::Luminosity: return blend_luminosity;
+		case Modes::Addition: return blend_separable<blend_addition>;
+		case Modes::Subtract: return blend_separable<blend_subtract>;
+		case Modes::Divide: return blend_separable<blend_divide>;
+		}
+
+		BLAH_ASSERT(false, "Unknown Aseprite blendmode");
+		return nullptr;
+	}
+
+	// Composites as many whole groups of 4 pixels as it can with the Normal blend mode,
+	// and returns how many pixels were written. The results match the scalar loop in
+	// render_cel exactly: the per-channel divide is done in floats, which is exact here
+	// since the quotient is never more than 255 and is truncated the same way.
+#if defined(BLAH_ASEPRITE_SSE2)
+
+	__m128i mul_un8(__m128i a, __m128i b)
+	{
+		// both are 0-255 in each 32-bit lane, so the product fits in the low 16 bits
+		__m128i t = _mm_add_epi32(_mm_mullo_epi16(a, b), _mm_set1_epi32(0x80));
+		return _mm_srli_epi32(_mm_add_epi32(_mm_srli_epi32(t, 8), t), 8);
+	}
+
+	__m128i mix_channel(__m128i s, __m128i d, __m128 sa, __m128 ra)
+	{
+		__m128 n = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(s, d)), sa);
+		return _mm_add_epi32(d, _mm_cvttps_epi32(_mm_div_ps(n, ra)));
+	}
+
+	__m128i select_bits(__m128i mask, __m128i a, __m128i b)
+	{
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	}
+
+	int composite_normal_simd(const Color* src, Color* dst, int count, int opacity)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i channel = _mm_set1_epi32(0xff);
+		const __m128i rgb = _mm_set1_epi32(0xffffff);
+		const __m128i opaque = _mm_set1_epi32(255);
+		const __m128i op = _mm_set1_epi32(opacity);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+			__m128i s_a = _mm_srli_epi32(s, 24);
+
+			// fully transparent source pixels leave the destination alone
+			__m128i skip = _mm_cmpeq_epi32(s_a, zero);
+			if (_mm_movemask_epi8(skip) == 0xffff)
+				continue;
+
+			__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+			__m128i d_a = _mm_srli_epi32(d, 24);
+			__m128i sa = mul_un8(s_a, op);
+			__m128i ra = _mm_sub_epi32(_mm_add_epi32(d_a, sa), mul_un8(d_a, sa));
+			__m128 saf = _mm_cvtepi32_ps(sa);
+			__m128 raf = _mm_max_ps(_mm_cvtepi32_ps(ra), _mm_set1_ps(1.0f));
+
+			__m128i r = mix_channel(_mm_and_si128(s, channel), _mm_and_si128(d, channel), saf, raf);
+			__m128i g = mix_channel(_mm_and_si128(_mm_srli_epi32(s, 8), channel), _mm_and_si128(_mm_srli_epi32(d, 8), channel), saf, raf);
+			__m128i b = mix_channel(_mm_and_si128(_mm_srli_epi32(s, 16), channel), _mm_and_si128(_mm_srli_epi32(d, 16), channel), saf, raf);
+			__m128i mixed = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)), _mm_or_si128(_mm_slli_epi32(b, 16), _mm_slli_epi32(ra, 24)));
+
+			// nothing underneath or fully opaque, so the source replaces the destination
+			__m128i replace = _mm_or_si128(_mm_cmpeq_epi32(d_a, zero), _mm_cmpeq_epi32(sa, opaque));
+			__m128i copied = _mm_or_si128(_mm_and_si128(s, rgb), _mm_slli_epi32(sa, 24));
+
+			__m128i result = select_bits(skip, d, select_bits(replace, copied, mixed));
+			_mm_storeu_si128((__m128i*)(dst + i), result);
+		}
+
+		return i;
+	}
+
+#elif defined(BLAH_ASEPRITE_NEON)
+
+	uint32x4_t mul_un8(uint32x4_t a, uint32x4_t b)
+	{
+		uint32x4_t t = vaddq_u32(vmulq_u32(a, b), vdupq_n_u32(0x80));
+		return vshrq_n_u32(vaddq_u32(vshrq_n_u32(t, 8), t), 8);
+	}
+
+	uint32x4_t mix_channel(uint32x4_t s, uint32x4_t d, float32x4_t sa, float32x4_t ra)
+	{
+		int32x4_t diff = vsubq_s32(vreinterpretq_s32_u32(s), vreinterpretq_s32_u32(d));
+		float32x4_t n = vmulq_f32(vcvtq_f32_s32(diff), sa);
+		return vreinterpretq_u32_s32(vaddq_s32(vreinterpretq_s32_u32(d), vcvtq_s32_f32(vdivq_f32(n, ra))));
+	}
+
+	int composite_normal_simd(const Color* src, Color* dst, int count, int opacity)
+	{
+		const uint32x4_t zero = vdupq_n_u32(0);
+		const uint32x4_t channel = vdupq_n_u32(0xff);
+		const uint32x4_t rgb = vdupq_n_u32(0xffffff);
+		const uint32x4_t opaque = vdupq_n_u32(255);
+		const uint32x4_t op = vdupq_n_u32((u32)opacity);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			uint32x4_t s = vld1q_u32((const u32*)(src + i));
+			uint32x4_t s_a = vshrq_n_u32(s, 24);
+
+			// fully transparent source pixels leave the destination alone
+			uint32x4_t skip = vceqq_u32(s_a, zero);
+			if (vminvq_u32(skip) == 0xffffffff)
+				continue;
+
+			uint32x4_t d = vld1q_u32((const u32*)(dst + i));
+			uint32x4_t d_a = vshrq_n_u32(d, 24);
+			uint32x4_t sa = mul_un8(s_a, op);
+			uint32x4_t ra = vsubq_u32(vaddq_u32(d_a, sa), mul_un8(d_a, sa));
+			float32x4_t saf = vcvtq_f32_u32(sa);
+			float32x4_t raf = vmaxq_f32(vcvtq_f32_u32(ra), vdupq_n_f32(1.0f));
+
+			uint32x4_t r = mix_channel(vandq_u32(s, channel), vandq_u32(d, channel), saf, raf);
+			uint32x4_t g = mix_channel(vandq_u32(vshrq_n_u32(s, 8), channel), vandq_u32(vshrq_n_u32(d, 8), channel), saf, raf);
+			uint32x4_t b = mix_channel(vandq_u32(vshrq_n_u32(s, 16), channel), vandq_u32(vshrq_n_u32(d, 16), channel), saf, raf);
+			uint32x4_t mixed = vorrq_u32(vorrq_u32(r, vshlq_n_u32(g, 8)), vorrq_u32(vshlq_n_u32(b, 16), vshlq_n_u32(ra, 24)));
+
+			// nothing underneath or fully opaque, so the source replaces the destination
+			uint32x4_t replace = vorrq_u32(vceqq_u32(d_a, zero), vceqq_u32(sa, opaque));
+			uint32x4_t copied = vorrq_u32(vandq_u32(s, rgb), vshlq_n_u32(sa, 24));
+
+			uint32x4_t result = vbslq_u32(skip, d, vbslq_u32(replace, copied, mixed));
+			vst1q_u32((u32*)(dst + i), result);
+		}
+
+		return i;
+	}
+
+#else
+
+	int composite_normal_simd(const Color*, Color*, int, int)
+	{
+		return 0;
+	}
+
+#endif
+}
+
 void Aseprite::render_cel(Cel* cel, Frame* frame)
 {
 	Layer& layer = layers[cel->layer_index];
@@ -378,30 +861,64 @@ void Aseprite::render_cel(Cel* cel, Frame* frame)
 	int top = Calc::max(0, srcY);
 	int bottom = Calc::min(dstH, srcY + srcH);
 
-	if (layer.blendmode == 0)
+	auto blend = get_blend_fn((BlendModes)layer.blendmode);
+
+	// walk row by row, so both the source and destination are read sequentially
+	for (int dy = top, sy = top - srcY; dy < bottom; dy++, sy++)
 	{
-		for (int dx = left, sx = -Calc::min(srcX, 0); dx < right; dx++, sx++)
+		const Color* srcColor = src + (left - srcX) + sy * srcW;
+		Color* dstColor = dst + left + dy * dstW;
+		int dx = left;
+
+		// the Normal mode is vectorized where possible, and the scalar loop finishes the row
+		if (blend == nullptr)
+		{
+			int done = composite_normal_simd(srcColor, dstColor, right - left, opacity);
+			dx += done;
+			srcColor += done;
+			dstColor += done;
+		}
+
+		for (; dx < right; dx++, srcColor++, dstColor++)
 		{
-			for (int dy = top, sy = -Calc::min(srcY, 0); dy < bottom; dy++, sy++)
+			if (srcColor->a == 0)
+				continue;
+
+			Color color = *srcColor;
+
+			// apply the blend mode. the result is mixed with the source
+			// color based on how opaque the backdrop is
+			if (blend != nullptr && dstColor->a != 0)
 			{
-				Color* srcColor = (src + sx + sy * srcW);
-				Color* dstColor = (dst + dx + dy * dstW);
+				Color blended = blend(*dstColor, color);
 
-				if (srcColor->a != 0)
+				if (dstColor->a == 255)
 				{
-					auto sa = MUL_UN8(srcColor->a, opacity, t);
-					auto ra = dstColor->a + sa - MUL_UN8(dstColor->a, sa, t);
-
-					dstColor->r = (unsigned char)(dstColor->r + (srcColor->r - dstColor->r) * sa / ra);
-					dstColor->g = (unsigned char)(dstColor->g + (srcColor->g - dstColor->g) * sa / ra);
-					dstColor->b = (unsigned char)(dstColor->b + (srcColor->b - dstColor->b) * sa / ra);
-					dstColor->a = (unsigned char)ra;
+					color = blended;
+				}
+				else
+				{
+					color.r = (u8)(color.r + (blended.r - color.r) * dstColor->a / 255);
+					color.g = (u8)(color.g + (blended.g - color.g) * dstColor->a / 255);
+					color.b = (u8)(color.b + (blended.b - color.b) * dstColor->a / 255);
 				}
 			}
+
+			auto sa = MUL_UN8(color.a, opacity, t);
+
+			// nothing underneath or fully opaque, so we can skip the divide
+			if (dstColor->a == 0 || sa == 255)
+			{
+				*dstColor = Color(color.r, color.g, color.b, (u8)sa);
+				continue;
+			}
+
+			auto ra = dstColor->a + sa - MUL_UN8(dstColor->a, sa, t);
+
+			dstColor->r = (unsigned char)(dstColor->r + (color.r - dstColor->r) * sa / ra);
+			dstColor->g = (unsigned char)(dstColor->g + (color.g - dstColor->g) * sa / ra);
+			dstColor->b = (unsigned char)(dstColor->b + (color.b - dstColor->b) * sa / ra);
+			dstColor->a = (unsigned char)ra;
 		}
 	}
-	else
-	{
-		BLAH_ASSERT(false, "Aseprite blendmodes aren't implemented");
-	}
 }
@@ -5,6 +5,10 @@
 #define STB_VORBIS_HEADER_ONLY
 #include "third_party/stb_vorbis.c"
 
+// cute_sound allocations go through Blah's memory hooks
+#define CUTE_SOUND_ALLOC(size, ctx) Blah::Memory::alloc(size, Blah::Memory::default_alignment, Blah::Memory::Tag::Audio)
+#define CUTE_SOUND_FREE(ptr, ctx) Blah::Memory::free(ptr)
+
 #define CUTE_SOUND_FORCE_SDL
 
 #define CUTE_SOUND_IMPLEMENTATION
@@ -41,6 +45,40 @@ namespace Blah
 		}
 	}
 
+	namespace
+	{
+		// gets the rest of the Stream's data, using it in place if it's already in memory,
+		// and otherwise reading it into the buffer. `length` is set to the amount available.
+		const u8* read_audio_stream(Stream& stream, Vector<u8>& buffer, size_t* length)
+		{
+			auto position = stream.position();
+			*length = stream.length() - position;
+
+			if (auto data = stream.data())
+			{
+				stream.seek(stream.length());
+				return data + position;
+			}
+
+			if (*length > (size_t)Vector<u8>::max_capacity)
+			{
+				Log::error("Unable to load audio as the Stream is too large");
+				*length = 0;
+				return nullptr;
+			}
+
+			u8* data = buffer.expand_uninitialized((i64)*length);
+			if (data == nullptr)
+			{
+				*length = 0;
+				return nullptr;
+			}
+
+			*length = stream.read(data, *length);
+			return data;
+		}
+	}
+
 	Audio::Audio(void* audio)
 	{
 		m_ptr = audio;
@@ -58,7 +96,7 @@ namespace Blah
 
 	AudioRef Audio::create(const FilePath& path)
 	{
-		FileStream fs(path, FileMode::OpenRead);
+		MappedFileStream fs(path);
 		if (!fs.is_readable())
 			return AudioRef();
 
@@ -80,14 +118,16 @@ namespace Blah
 			return AudioRef();
 		}
 
-		// read into buffer
+		Memory::TagScope tag(Memory::Tag::Audio);
+
+		// read into buffer, unless the data is already in memory
 		Vector<u8> buffer;
-		buffer.reserve((int)stream.length());
-		stream.read(buffer.data(), stream.length());
+		size_t length = 0;
+		const u8* data = read_audio_stream(stream, buffer, &length);
 
 		// load wav file from memory using cute_sound.h
 		cs_error_t err;
-		void* audio = cs_read_mem_wav((void*)buffer.data(), stream.length(), &err);
+		void* audio = cs_read_mem_wav((void*)data, length, &err);
 		if (!audio) {
 			Log::error(cs_error_as_string(err));
 			return AudioRef();
@@ -104,14 +144,16 @@ namespace Blah
 			return AudioRef();
 		}
 
-		// read into buffer
+		Memory::TagScope tag(Memory::Tag::Audio);
+
+		// read into buffer, unless the data is already in memory
 		Vector<u8> buffer;
-		buffer.reserve((int)stream.length());
-		stream.read(buffer.data(), stream.length());
+		size_t length = 0;
+		const u8* data = read_audio_stream(stream, buffer, &length);
 
 		// load ogg file from memory using cute_sound.h
 		cs_error_t err;
-		void* audio = cs_read_mem_ogg((void*)buffer.data(), stream.length(), &err);
+		void* audio = cs_read_mem_ogg((void*)data, length, &err);
 		if (!audio) {
 			Log::error(cs_error_as_string(err));
 			return AudioRef();
@@ -34,19 +34,20 @@ namespace
 	(vert)->col = c; \
 	(vert)->mult = m; \
 	(vert)->wash = w; \
-	(vert)->fill = f;
+	(vert)->fill = f; \
+	(vert)->pad = 0;
 	
 #define PUSH_QUAD(px0, py0, px1, py1, px2, py2, px3, py3, tx0, ty0, tx1, ty1, tx2, ty2, tx3, ty3, col0, col1, col2, col3, mult, fill, wash) \
 	{ \
 		m_batch.elements += 2; \
-		auto _i = m_indices.expand(6); \
+		auto _i = m_indices.expand_uninitialized(6); \
 		*_i++ = (u32)m_vertices.size() + 0; \
 		*_i++ = (u32)m_vertices.size() + 1; \
 		*_i++ = (u32)m_vertices.size() + 2; \
 		*_i++ = (u32)m_vertices.size() + 0; \
 		*_i++ = (u32)m_vertices.size() + 2; \
 		*_i++ = (u32)m_vertices.size() + 3; \
-		Vertex* _v = m_vertices.expand(4); \
+		Vertex* _v = m_vertices.expand_uninitialized(4); \
 		if (integerize) { \
 			MAKE_VERTEX(_v, m_matrix, px0, py0, tx0, ty0, col0, mult, fill, wash, Calc::floor); _v++; \
 			MAKE_VERTEX(_v, m_matrix, px1, py1, tx1, ty1, col1, mult, fill, wash, Calc::floor); _v++; \
@@ -63,11 +64,11 @@ namespace
 #define PUSH_TRIANGLE(px0, py0, px1, py1, px2, py2, tx0, ty0, tx1, ty1, tx2, ty2, col0, col1, col2, mult, fill, wash) \
 	{ \
 		m_batch.elements += 1; \
-		auto* _i = m_indices.expand(3); \
+		auto* _i = m_indices.expand_uninitialized(3); \
 		*_i++ = (u32)m_vertices.size() + 0; \
 		*_i++ = (u32)m_vertices.size() + 1; \
 		*_i++ = (u32)m_vertices.size() + 2; \
-		Vertex* _v = m_vertices.expand(3); \
+		Vertex* _v = m_vertices.expand_uninitialized(3); \
 		if (integerize) { \
 			MAKE_VERTEX(_v, m_matrix, px0, py0, tx0, ty0, col0, mult, fill, wash, Calc::floor); _v++; \
 			MAKE_VERTEX(_v, m_matrix, px1, py1, tx1, ty1, col1, mult, fill, wash, Calc::floor); _v++; \
@@ -242,6 +243,74 @@ Batch::ColorMode Batch::peek_color_mode() const
 	return m_color_mode;
 }
 
+bool Batch::SdfStyle::operator==(const SdfStyle& rhs) const
+{
+	return
+		outline_width == rhs.outline_width &&
+		outline_color == rhs.outline_color &&
+		shadow_offset == rhs.shadow_offset &&
+		shadow_softness == rhs.shadow_softness &&
+		shadow_color == rhs.shadow_color;
+}
+
+void Batch::push_sdf_style(const SdfStyle& style)
+{
+	m_sdf_style_stack.push_back(m_sdf_style);
+	m_sdf_style = style;
+}
+
+Batch::SdfStyle Batch::pop_sdf_style()
+{
+	SdfStyle was = m_sdf_style;
+	m_sdf_style = m_sdf_style_stack.pop();
+	return was;
+}
+
+Batch::SdfStyle Batch::peek_sdf_style() const
+{
+	return m_sdf_style;
+}
+
+MaterialRef Batch::get_sdf_material(int spread)
+{
+	// reuse a material that's already been set up this frame
+	for (int i = 0; i < m_sdf_materials_used; i++)
+	{
+		auto& it = m_sdf_materials[i];
+		if (it.spread == spread && it.style == m_sdf_style)
+			return it.material;
+	}
+
+	// materials from previous frames are reused once they've been drawn
+	if (m_sdf_materials_used >= m_sdf_materials.size())
+	{
+		BLAH_ASSERT_RENDERER();
+
+		auto renderer = Internal::app_renderer();
+		if (!renderer || !renderer->sdf_batcher_shader)
+			return MaterialRef();
+
+		auto material = Material::create(renderer->sdf_batcher_shader);
+		if (!material)
+			return MaterialRef();
+
+		m_sdf_materials.push_back({ SdfStyle(), 0, material });
+	}
+
+	auto& it = m_sdf_materials[m_sdf_materials_used++];
+	it.style = m_sdf_style;
+	it.spread = spread;
+
+	// converts the stored distance (where 128 is the edge) to pixels
+	float distance_scale = 255.0f * spread / 128.0f;
+
+	it.material->set_value("u_sdf", Vec4f(distance_scale, it.style.outline_width, it.style.shadow_softness, 0));
+	it.material->set_value("u_outline_color", it.style.outline_color.to_vec4());
+	it.material->set_value("u_shadow_color", it.style.shadow_color.to_vec4());
+	it.material->set_value("u_shadow_offset", it.style.shadow_offset);
+	return it.material;
+}
+
 void Batch::set_texture(const TextureRef& texture)
 {
 	if (m_batch.elements > 0 && texture != m_batch.texture && m_batch.texture)
@@ -287,6 +356,11 @@ void Batch::render(const TargetRef& target, const Mat4x4f& matrix)
 		}
 	}
 
+	// intern the uniform names once, so each batch can look them up without comparing strings
+	m_texture_uniform = StringId(texture_uniform);
+	m_sampler_uniform = StringId(sampler_uniform);
+	m_matrix_uniform = StringId(matrix_uniform);
+
 	// upload data
 	m_mesh->index_data(IndexFormat::UInt32, m_indices.data(), m_indices.size());
 	m_mesh->vertex_data(format, m_vertices.data(), m_vertices.size());
@@ -324,18 +398,18 @@ void Batch::render_single_batch(DrawCall& pass, const DrawBatch& b, const Mat4x4
 		pass.material = m_default_material;
 	
 	// assign texture & sampler, fallback to whatever the first one is if the names are different
-	if (pass.material->has_value(texture_uniform))
-		pass.material->set_texture(texture_uniform, b.texture);
+	if (pass.material->has_value(m_texture_uniform))
+		pass.material->set_texture(m_texture_uniform, b.texture);
 	else
 		pass.material->set_texture(0, b.texture);
 
-	if (pass.material->has_value(sampler_uniform))
-		pass.material->set_sampler(sampler_uniform, b.sampler);
+	if (pass.material->has_value(m_sampler_uniform))
+		pass.material->set_sampler(m_sampler_uniform, b.sampler);
 	else
 		pass.material->set_sampler(0, b.sampler);
 
 	// assign the matrix uniform
-	pass.material->set_value(matrix_uniform, matrix);
+	pass.material->set_value(m_matrix_uniform, &matrix.m11, 16);
 	
 	pass.blend = b.blend;
 	pass.has_scissor = b.scissor.w >= 0 && b.scissor.h >= 0;
@@ -375,6 +449,10 @@ void Batch::clear()
 	m_batches.clear();
 
 	m_batch_insert = 0;
+
+	m_sdf_style = SdfStyle();
+	m_sdf_style_stack.clear();
+	m_sdf_materials_used = 0;
 }
 
 void Batch::dispose()
@@ -390,6 +468,8 @@ void Batch::dispose()
 	m_color_mode_stack.dispose();
 	m_layer_stack.dispose();
 	m_batches.dispose();
+	m_sdf_style_stack.dispose();
+	m_sdf_materials.dispose();
 
 	m_default_material.reset();
 	m_mesh.reset();
@@ -958,50 +1038,177 @@ void Batch::str(const SpriteFont& font, const String& text, const Vec2f& pos, Co
 
 void Batch::str(const SpriteFont& font, const String& text, const Vec2f& pos, const Vec2f& justify, float size, Color color)
 {
+	if (text.length() <= 0)
+		return;
+
 	push_matrix(
 		Mat3x2f::create_scale(size / font.size) *
 		Mat3x2f::create_translation(pos)
 	);
 
+	// signed distance field fonts are drawn with their own material, unless one has been pushed
+	bool sdf_material = (font.is_sdf() && !m_batch.material);
+	if (sdf_material)
+		push_material(get_sdf_material(font.sdf_spread()));
+
+	// measure every line at once, rather than once per line
+	bool justified = (justify.x != 0 || justify.y != 0);
+	if (justified)
+		font.measure(text, m_str_measurement);
+
 	Vec2f offset = Vec2f(0, font.ascent + font.descent);
-	if (justify.x != 0)
-		offset.x -= font.width_of_line(text) * justify.x;
-	if (justify.y != 0)
-		offset.y -= font.height_of(text) * justify.y;
+	if (justified)
+		offset -= Vec2f(m_str_measurement.line_widths[0], m_str_measurement.size.y) * justify;
+
+	// glyphs outside of the scissor are skipped
+	Rectf cull;
+	bool culling = get_text_cull_bounds(&cull);
+	bool line_start = true;
 
+	int line = 0;
 	u32 last = 0;
-	Utf8 utf8(text.cstr());
-	int i = 0;
-	while (utf8.character)
+	auto it = text.cstr();
+	while (*it)
 	{
-		if (utf8.character == '\n')
+		// skip whole lines outside of the cull bounds. glyphs can extend past the ascent & descent, so there's some margin
+		if (line_start && culling)
 		{
+			line_start = false;
+
+			// lines only move down, so every following line is culled too
+			if (offset.y - font.ascent - font.line_height() > cull.bottom())
+				break;
+
+			if (offset.y - font.descent + font.line_height() < cull.y)
+			{
+				while (*it && *it != '\n')
+					it++;
+				continue;
+			}
+		}
+
+		// ascii characters don't need to be decoded
+		u32 codepoint = (u8)*it;
+		if (codepoint < 0x80)
+		{
+			it++;
+		}
+		else
+		{
+			Utf8 utf8(it);
+			codepoint = utf8.character;
+			it += utf8.character_size;
+		}
+
+		if (codepoint == '\n')
+		{
+			line++;
 			offset.x = 0;
 			offset.y += font.line_height();
 
 			if (justify.x != 0)
-				offset.x -= font.width_of_line(text, i + 1) * justify.x;
+				offset.x -= m_str_measurement.line_widths[line] * justify.x;
 
 			last = 0;
+			line_start = true;
 		}
 		else
 		{
-			const auto& ch = font[utf8.character];
+			// kerning is carried forward, matching SpriteFont::measure and TextLayout
+			if (last)
+				offset.x += font.get_kerning(last, codepoint);
+
+			const auto& ch = font[codepoint];
 			if (ch.subtexture.texture)
 			{
 				Vec2f at = offset + ch.offset;
-				if (last)
-					at.x += font.get_kerning(last, utf8.character);
-				tex(ch.subtexture, at, color);
+
+				if (!culling || Rectf(at.x, at.y, ch.subtexture.width(), ch.subtexture.height()).overlaps(cull))
+					tex(ch.subtexture, at, color);
 			}
 
 			offset.x += ch.advance;
-			last = utf8.character;
+			last = codepoint;
 		}
+	}
+
+	if (sdf_material)
+		pop_material();
+
+	pop_matrix();
+}
+
+bool Batch::get_text_cull_bounds(Rectf* bounds) const
+{
+	const auto& scissor = m_batch.scissor;
+	if (!cull_text || scissor.w < 0 || scissor.h < 0)
+		return false;
+
+	// a matrix that can't be inverted has nothing sensible to cull against
+	if (m_matrix.m11 * m_matrix.m22 - m_matrix.m21 * m_matrix.m12 == 0)
+		return false;
+
+	// Bounds of the scissor in local space. If the matrix is rotated this is larger than the
+	// scissor itself, so it may not cull every hidden glyph, but never culls a visible one.
+	auto inverse = m_matrix.invert();
+	auto a = Vec2f::transform(scissor.top_left(), inverse);
+	auto b = Vec2f::transform(scissor.top_right(), inverse);
+	auto c = Vec2f::transform(scissor.bottom_right(), inverse);
+	auto d = Vec2f::transform(scissor.bottom_left(), inverse);
+
+	*bounds = Rectf::from_points(
+		Vec2f::min(Vec2f::min(a, b), Vec2f::min(c, d)),
+		Vec2f::max(Vec2f::max(a, b), Vec2f::max(c, d)));
+	return true;
+}
 
-		i += utf8.character_size;
-		utf8.next();
+void Batch::str(const TextLayout& layout, const Vec2f& pos, Color color)
+{
+	str(layout, Mat3x2f::create_translation(pos), color);
+}
+
+void Batch::str(const TextLayout& layout, const Mat3x2f& matrix, Color color)
+{
+	push_matrix(matrix);
+
+	bool sdf_material = (layout.sdf_spread > 0 && !m_batch.material);
+	if (sdf_material)
+		push_material(get_sdf_material(layout.sdf_spread));
+
+	// lines & glyphs outside of the scissor are skipped
+	Rectf cull;
+	if (get_text_cull_bounds(&cull))
+	{
+		for (auto& line : layout.lines)
+		{
+			// glyphs can extend a little past the bounds of their line
+			float margin = line.bounds.h;
+
+			// lines only move down, so every following line is culled too
+			if (line.bounds.y - margin > cull.bottom())
+				break;
+
+			if (line.bounds.bottom() + margin < cull.y ||
+				line.bounds.right() + margin < cull.x ||
+				line.bounds.x - margin > cull.right())
+				continue;
+
+			for (int i = line.glyph_start, n = line.glyph_start + line.glyph_count; i < n; i++)
+			{
+				auto& it = layout.glyphs[i];
+				if (Rectf(it.position.x, it.position.y, it.subtexture.width(), it.subtexture.height()).overlaps(cull))
+					tex(it.subtexture, it.position, color);
+			}
+		}
 	}
+	else
+	{
+		for (auto& it : layout.glyphs)
+			tex(it.subtexture, it.position, color);
+	}
+
+	if (sdf_material)
+		pop_material();
 
 	pop_matrix();
 }
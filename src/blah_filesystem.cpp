@@ -1,8 +1,285 @@
 #include <blah_filesystem.h>
 #include "internal/blah_internal.h"
 
+#ifndef BLAH_NO_THREADING
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
 using namespace Blah;
 
+namespace
+{
+	struct FileRequest
+	{
+		FilePath path;
+		u32 path_hash = 0;
+		u64 order = 0;
+		bool write = false;
+		bool success = false;
+		Vector<u8> data;
+		Func<void, FileReadResult&> on_read;
+		Func<void, const FileWriteResult&> on_write;
+	};
+
+	// file access is mostly spent waiting on the disk, so a couple of
+	// threads keeps it busy without competing with the rest of the game
+	constexpr int file_worker_count = 2;
+
+	void blah_run_file_request(FileRequest& request)
+	{
+		if (request.write)
+		{
+			auto file = File::open(request.path, FileMode::CreateWrite);
+			auto length = (size_t)request.data.size();
+
+			request.success = file && (length <= 0 || file->write(request.data.data(), length) == length);
+			request.data.dispose();
+		}
+		else if (auto file = File::open(request.path, FileMode::OpenRead))
+		{
+			auto length = file->length();
+			if (length > (size_t)Vector<u8>::max_capacity)
+			{
+				Log::error("Unable to read '%s' as it is too large", request.path.cstr());
+				return;
+			}
+
+			if (length > 0)
+			{
+				auto data = request.data.expand_uninitialized((i64)length);
+				if (data == nullptr)
+					return;
+
+				auto read = file->read(data, length);
+				request.data.resize((i64)read);
+				request.success = (read == length);
+			}
+			else
+				request.success = true;
+		}
+	}
+
+	void blah_dispatch_file_request(FileRequest& request)
+	{
+		if (request.write)
+		{
+			if (request.on_write)
+			{
+				FileWriteResult result;
+				result.path = std::move(request.path);
+				result.success = request.success;
+				request.on_write(result);
+			}
+		}
+		else if (request.on_read)
+		{
+			FileReadResult result;
+			result.path = std::move(request.path);
+			result.success = request.success;
+			result.data = std::move(request.data);
+			request.on_read(result);
+		}
+	}
+
+	// runs async file requests on a small pool of background threads,
+	// and holds on to them once they're finished until the main thread dispatches them
+	class FileQueue
+	{
+	public:
+		Vector<FileRequest> completed;
+
+		Vector<FileRequest> take_completed()
+		{
+#ifndef BLAH_NO_THREADING
+			std::lock_guard<std::mutex> lock(mutex);
+#endif
+			return std::move(completed);
+		}
+
+#ifndef BLAH_NO_THREADING
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable idle;
+		Vector<std::thread> workers;
+		Vector<FileRequest> queued[3];
+		Vector<const FileRequest*> running;
+		u64 next_order = 0;
+		bool stopping = false;
+
+		void push(FileRequest&& request, FilePriority priority)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			request.order = next_order++;
+			queued[(int)priority].push_back(std::move(request));
+
+			if (workers.size() <= 0)
+			{
+				for (int i = 0; i < file_worker_count; i++)
+					workers.emplace_back([this]() { run(); });
+			}
+
+			wake.notify_one();
+		}
+
+		int pending()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return (int)(queued_count() + running.size() + completed.size());
+		}
+
+		void wait()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			idle.wait(lock, [this]() { return queued_count() <= 0 && running.size() <= 0; });
+		}
+
+		void shutdown()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+
+				// queued reads are dropped, but writes are still finished so no data is lost
+				for (auto& list : queued)
+				{
+					for (i64 i = list.size() - 1; i >= 0; i--)
+						if (!list[i].write)
+							list.erase(i);
+				}
+
+				stopping = true;
+				wake.notify_all();
+			}
+
+			for (auto& it : workers)
+				it.join();
+
+			workers.clear();
+			completed.clear();
+			stopping = false;
+		}
+
+		~FileQueue()
+		{
+			shutdown();
+		}
+
+	private:
+		i64 queued_count() const
+		{
+			return queued[0].size() + queued[1].size() + queued[2].size();
+		}
+
+		static bool same_file(const FileRequest& a, const FileRequest& b)
+		{
+			return a.path_hash == b.path_hash && a.path == b.path;
+		}
+
+		// whether the request has to wait for another one on the same file,
+		// either because it's running or because it was queued earlier (at any priority)
+		bool is_blocked(const FileRequest& request) const
+		{
+			for (auto& it : running)
+				if (same_file(*it, request))
+					return true;
+
+			for (auto& list : queued)
+				for (auto& it : list)
+				{
+					// each list is in the order requests were made
+					if (it.order >= request.order)
+						break;
+					if (same_file(it, request))
+						return true;
+				}
+
+			return false;
+		}
+
+		// takes the next request that can be run, skipping any for files that are already being read or written
+		bool take_next(FileRequest* request)
+		{
+			for (int priority = 2; priority >= 0; priority--)
+			{
+				auto& list = queued[priority];
+
+				for (i64 i = 0; i < list.size(); i++)
+				{
+					if (is_blocked(list[i]))
+						continue;
+
+					*request = std::move(list[i]);
+					list.erase(i);
+					running.push_back(request);
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void run()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			while (true)
+			{
+				FileRequest request;
+				bool has_request = false;
+
+				wake.wait(lock, [&]()
+				{
+					has_request = take_next(&request);
+					return has_request || (stopping && queued_count() <= 0);
+				});
+
+				if (!has_request)
+					break;
+
+				lock.unlock();
+				blah_run_file_request(request);
+				lock.lock();
+
+				for (i64 i = 0; i < running.size(); i++)
+					if (running[i] == &request)
+					{
+						running.erase(i);
+						break;
+					}
+
+				completed.push_back(std::move(request));
+
+				// requests for the same file may have been waiting on this one
+				wake.notify_all();
+				if (queued_count() <= 0 && running.size() <= 0)
+					idle.notify_all();
+			}
+		}
+#else
+		void push(FileRequest&& request, FilePriority)
+		{
+			blah_run_file_request(request);
+			completed.push_back(std::move(request));
+		}
+
+		int pending()
+		{
+			return (int)completed.size();
+		}
+
+		void wait() {}
+
+		void shutdown()
+		{
+			completed.clear();
+		}
+#endif
+	};
+
+	FileQueue g_file_queue;
+}
+
 FileRef File::open(const FilePath& path, FileMode mode)
 {
 	BLAH_ASSERT_RUNNING();
@@ -31,11 +308,58 @@ bool File::destroy(const FilePath& path)
 	return false;
 }
 
+void File::read_async(const FilePath& path, const Func<void, FileReadResult&>& on_complete, FilePriority priority)
+{
+	BLAH_ASSERT_RUNNING();
+
+	FileRequest request;
+	request.path = path;
+	request.path_hash = path.hash();
+	request.on_read = on_complete;
+	g_file_queue.push(std::move(request), priority);
+}
+
+void File::write_async(const FilePath& path, Vector<u8>&& data, const Func<void, const FileWriteResult&>& on_complete, FilePriority priority)
+{
+	BLAH_ASSERT_RUNNING();
+
+	FileRequest request;
+	request.path = path;
+	request.path_hash = path.hash();
+	request.write = true;
+	request.data = std::move(data);
+	request.on_write = on_complete;
+	g_file_queue.push(std::move(request), priority);
+}
+
+int File::pending_async()
+{
+	return g_file_queue.pending();
+}
+
+void File::wait_async()
+{
+	g_file_queue.wait();
+	Internal::file_update();
+}
+
 FileMode File::mode() const
 {
 	return m_mode;
 }
 
+void Internal::file_update()
+{
+	auto finished = g_file_queue.take_completed();
+	for (auto& it : finished)
+		blah_dispatch_file_request(it);
+}
+
+void Internal::file_shutdown()
+{
+	g_file_queue.shutdown();
+}
+
 bool Directory::create(const FilePath& path)
 {
 	BLAH_ASSERT_RUNNING();
@@ -1,8 +1,13 @@
 #include <blah_font.h>
 #include <blah_calc.h>
+#include "internal/blah_platform.h"
 
 using namespace Blah;
 
+// stb allocations go through Blah's memory hooks
+#define STBTT_malloc(size, user) ((void)(user), Blah::Memory::alloc(size, Blah::Memory::default_alignment, Blah::Memory::Tag::Font))
+#define STBTT_free(ptr, user) ((void)(user), Blah::Memory::free(ptr))
+
 #define STBTT_STATIC
 #define STB_TRUETYPE_IMPLEMENTATION
 #include "third_party/stb_truetype.h"
@@ -30,23 +35,121 @@ namespace
 	}
 }
 
-FontRef Font::create(Stream& stream)
+FontData::~FontData()
+{
+	if (m_mapped)
+		Platform::file_unmap((void*)m_data, m_length);
+}
+
+FontDataRef FontData::create(const FilePath& path)
+{
+	size_t length = 0;
+	if (auto mapped = Platform::file_map(path.cstr(), &length))
+	{
+		auto data = FontDataRef(new FontData());
+		data->m_data = (const u8*)mapped;
+		data->m_length = length;
+		data->m_mapped = true;
+		return data;
+	}
+
+	FileStream fs(path, FileMode::OpenRead);
+	if (fs.is_readable())
+		return create(fs);
+
+	Log::error("Unable to open Font file: %s", path.cstr());
+	return FontDataRef();
+}
+
+FontDataRef FontData::create(Stream& stream)
 {
 	if (!stream.is_readable())
 	{
 		Log::error("Unable to load a font as the Stream was not readable");
+		return FontDataRef();
+	}
+
+	Memory::TagScope tag(Memory::Tag::Font);
+
+	auto data = FontDataRef(new FontData());
+	data->m_buffer.resize((i64)(stream.length() - stream.position()));
+	data->m_buffer.resize((i64)stream.read(data->m_buffer.data(), (size_t)data->m_buffer.size()));
+	data->m_data = data->m_buffer.data();
+	data->m_length = (size_t)data->m_buffer.size();
+	return data;
+}
+
+FontDataRef FontData::create(const u8* data, size_t length)
+{
+	BLAH_ASSERT(data != nullptr, "Font data must not be null");
+
+	auto result = FontDataRef(new FontData());
+	result->m_data = data;
+	result->m_length = length;
+	return result;
+}
+
+const u8* FontData::data() const
+{
+	return m_data;
+}
+
+size_t FontData::length() const
+{
+	return m_length;
+}
+
+bool FontData::is_mapped() const
+{
+	return m_mapped;
+}
+
+int FontData::font_count() const
+{
+	if (m_length <= 0)
+		return 0;
+	return Calc::max(stbtt_GetNumberOfFonts(m_data), 0);
+}
+
+FontRef Font::create(Stream& stream)
+{
+	if (auto data = FontData::create(stream))
+		return create(data);
+	return FontRef();
+}
+
+FontRef Font::create(const FilePath& path)
+{
+	if (auto data = FontData::create(path))
+		return create(data);
+	return FontRef();
+}
+
+FontRef Font::create(const u8* data, size_t length)
+{
+	return create(FontData::create(data, length));
+}
+
+FontRef Font::create(const FontDataRef& data, int index)
+{
+	if (!data || data->length() <= 0)
+	{
+		Log::error("Unable to load a font as there was no data");
 		return FontRef();
 	}
 
-	// read into buffer
-	Vector<u8> buffer;
-	buffer.reserve(stream.length());
-	stream.read(buffer.data(), stream.length());
+	// fonts within collections start at different offsets
+	int offset = stbtt_GetFontOffsetForIndex(data->data(), index);
+	if (offset < 0)
+	{
+		Log::error("Font data has no font at index %i", index);
+		return FontRef();
+	}
 
 	// init font
 	auto stbtt = Ref<stbtt_fontinfo>(new stbtt_fontinfo());
 	auto fn = (stbtt_fontinfo*)stbtt.get();
-	if (stbtt_InitFont(fn, buffer.data(), 0) == 0)
+	if (stbtt_InitFont(fn, data->data(), offset) == 0)
 	{
 		Log::error("Unable to parse Font file");
 		return FontRef();
@@ -55,19 +158,16 @@ FontRef Font::create(Stream& stream)
 	// setup
 	auto font = FontRef(new Font());
 	font->m_font = stbtt;
-	font->m_buffer = std::move(buffer);
+	font->m_data = data;
 	font->m_family_name = blah_get_font_name(fn, 1);
 	font->m_style_name = blah_get_font_name(fn, 2);
 	stbtt_GetFontVMetrics(fn, &font->m_ascent, &font->m_descent, &font->m_line_gap);
 	return font;
 }
 
-FontRef Font::create(const FilePath& path)
+const FontDataRef& Font::data() const
 {
-	FileStream fs(path, FileMode::OpenRead);
-	if (fs.is_readable())
-		return create(fs);
-	return FontRef();
+	return m_data;
 }
 
 const String& Font::family_name() const
@@ -105,6 +205,16 @@ int Font::line_height() const
 	return m_ascent - m_descent + m_line_gap;
 }
 
+Recti Font::bounding_box() const
+{
+	if (!m_font)
+		return Recti();
+
+	int x0, y0, x1, y1;
+	stbtt_GetFontBoundingBox((stbtt_fontinfo*)m_font.get(), &x0, &y0, &x1, &y1);
+	return Recti(x0, y0, x1 - x0, y1 - y0);
+}
+
 int Font::get_glyph(Codepoint codepoint) const
 {
 	if (!m_font)
@@ -127,6 +237,74 @@ float Font::get_kerning(int glyph1, int glyph2, float scale) const
 	return stbtt_GetGlyphKernAdvance((stbtt_fontinfo*)m_font.get(), glyph1, glyph2) * scale;
 }
 
+bool Font::get_kerning_pairs(Vector<KerningPair>& pairs, float scale) const
+{
+	if (!m_font)
+		return false;
+
+	auto fn = (stbtt_fontinfo*)m_font.get();
+
+	// stbtt only uses the kern table if there's no GPOS table
+	if (fn->gpos)
+		return false;
+
+	int length = stbtt_GetKerningTableLength(fn);
+	if (length > 0)
+	{
+		Vector<stbtt_kerningentry> table;
+		table.expand(length);
+		length = stbtt_GetKerningTable(fn, table.data(), length);
+
+		pairs.reserve(pairs.size() + length);
+		for (int i = 0; i < length; i++)
+		{
+			auto& it = table[i];
+			if (it.advance != 0)
+				pairs.push_back({ it.glyph1, it.glyph2, it.advance * scale });
+		}
+	}
+
+	return true;
+}
+
+bool Font::has_kerning(int glyph) const
+{
+	if (!m_font)
+		return false;
+
+	auto fn = (stbtt_fontinfo*)m_font.get();
+
+	if (fn->gpos)
+	{
+		// check if the glyph is in the coverage of any pair adjustment subtable
+		stbtt_uint8* data = fn->data + fn->gpos;
+		if (ttUSHORT(data + 0) != 1 || ttUSHORT(data + 2) != 0)
+			return false;
+
+		stbtt_uint8* lookup_list = data + ttUSHORT(data + 8);
+		stbtt_uint16 lookup_count = ttUSHORT(lookup_list);
+
+		for (int i = 0; i < lookup_count; i++)
+		{
+			stbtt_uint8* lookup_table = lookup_list + ttUSHORT(lookup_list + 2 + 2 * i);
+			if (ttUSHORT(lookup_table) != 2)
+				continue;
+
+			stbtt_uint16 subtable_count = ttUSHORT(lookup_table + 4);
+			for (int j = 0; j < subtable_count; j++)
+			{
+				stbtt_uint8* table = lookup_table + ttUSHORT(lookup_table + 6 + 2 * j);
+				if (stbtt__GetCoverageIndex(table + ttUSHORT(table + 2), glyph) != -1)
+					return true;
+			}
+		}
+
+		return false;
+	}
+
+	return fn->kern != 0;
+}
+
 Font::Character Font::get_character(int glyph, float scale) const
 {
 	Character ch;
@@ -187,4 +365,42 @@ Image Font::get_image(const Font::Character& ch) const
 		return img;
 
 	return Image();
+}
+
+Font::Character Font::get_sdf_character(int glyph, float scale, int spread) const
+{
+	Character ch = get_character(glyph, scale);
+
+	if (ch.has_glyph)
+	{
+		ch.width += spread * 2;
+		ch.height += spread * 2;
+		ch.offset_x -= spread;
+		ch.offset_y -= spread;
+	}
+
+	return ch;
+}
+
+bool Font::get_sdf_image(const Font::Character& ch, int spread, Color* pixels) const
+{
+	if (!ch.has_glyph || spread <= 0)
+		return false;
+
+	int w, h, x, y;
+	auto* sdf = stbtt_GetGlyphSDF((stbtt_fontinfo*)m_font.get(), ch.scale, ch.glyph, spread, 128, 128.0f / spread, &w, &h, &x, &y);
+	if (sdf == nullptr)
+		return false;
+
+	// the distance goes in the alpha channel, so it can be packed & uploaded like any other image
+	int copy_w = Calc::min(w, ch.width);
+	int copy_h = Calc::min(h, ch.height);
+	for (int i = 0; i < ch.width * ch.height; i++)
+		pixels[i] = Color::transparent;
+	for (int py = 0; py < copy_h; py++)
+		for (int px = 0; px < copy_w; px++)
+			pixels[px + py * ch.width] = Color(255, 255, 255, sdf[px + py * w]);
+
+	stbtt_FreeSDF(sdf, nullptr);
+	return true;
 }
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include <blah_framearena.h>
+#include <blah_vector.h>
+
+using namespace Blah;
+
+namespace
+{
+	struct Block
+	{
+		u8* data;
+		size_t capacity;
+	};
+
+	Vector<Block> blah_blocks;
+	int blah_block = 0;          // the block currently being allocated from
+	size_t blah_offset = 0;      // offset into the current block
+	size_t blah_last_offset = 0; // offset of the most recent allocation, so it can be extended
+	size_t blah_block_size = FrameArena::default_block_size;
+	FrameArena::Stats blah_stats;
+
+	bool blah_add_block(size_t capacity)
+	{
+		auto data = (u8*)Memory::alloc(capacity, Memory::default_alignment);
+		if (data == nullptr)
+		{
+			Log::error("Failed to allocate %zu bytes for the FrameArena", capacity);
+			return false;
+		}
+
+		blah_blocks.push_back({ data, capacity });
+		blah_stats.capacity += capacity;
+		blah_stats.blocks++;
+		return true;
+	}
+
+	// gets the offset of an aligned allocation in the block, or SIZE_MAX if it won't fit
+	size_t blah_fit(const Block& block, size_t offset, size_t size, size_t alignment)
+	{
+		size_t address = (size_t)(block.data + offset);
+		size_t aligned = ((address + alignment - 1) & ~(alignment - 1)) - (size_t)block.data;
+
+		if (aligned > block.capacity || size > block.capacity - aligned)
+			return SIZE_MAX;
+		return aligned;
+	}
+}
+
+void* FrameArena::alloc(size_t size, size_t alignment)
+{
+	BLAH_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of 2");
+
+	if (size == 0)
+		size = 1;
+
+	if (size > SIZE_MAX / 2 - alignment)
+		return nullptr;
+
+	// find a block it fits in, moving on to the next block if the current one is full
+	size_t offset = SIZE_MAX;
+	while (blah_block < blah_blocks.size())
+	{
+		offset = blah_fit(blah_blocks[blah_block], blah_offset, size, alignment);
+		if (offset != SIZE_MAX)
+			break;
+
+		blah_block++;
+		blah_offset = 0;
+	}
+
+	// add a new block large enough for the allocation
+	if (offset == SIZE_MAX)
+	{
+		size_t capacity = blah_block_size;
+		while (capacity < size + alignment)
+			capacity *= 2;
+
+		if (!blah_add_block(capacity))
+			return nullptr;
+
+		blah_block = (int)blah_blocks.size() - 1;
+		blah_offset = 0;
+		offset = blah_fit(blah_blocks[blah_block], 0, size, alignment);
+	}
+
+	blah_stats.bytes += (offset - blah_offset) + size;
+	blah_stats.allocations++;
+	blah_last_offset = offset;
+	blah_offset = offset + size;
+	return blah_blocks[blah_block].data + offset;
+}
+
+bool FrameArena::extend(void* ptr, size_t size, size_t new_size)
+{
+	if (ptr == nullptr || blah_block >= blah_blocks.size())
+		return false;
+
+	auto& block = blah_blocks[blah_block];
+
+	// only the most recent allocation can be extended
+	if ((u8*)ptr != block.data + blah_last_offset || blah_offset - blah_last_offset != size)
+		return false;
+
+	if (new_size < size || new_size > block.capacity - blah_last_offset)
+		return false;
+
+	blah_stats.bytes += new_size - size;
+	blah_offset = blah_last_offset + new_size;
+	return true;
+}
+
+const char* FrameArena::format(const char* fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	auto length = vsnprintf(nullptr, 0, fmt, args);
+	va_end(args);
+
+	if (length < 0)
+		return "";
+
+	auto result = (char*)alloc((size_t)length + 1, 1);
+	if (result == nullptr)
+		return "";
+
+	va_start(args, fmt);
+	vsnprintf(result, (size_t)length + 1, fmt, args);
+	va_end(args);
+
+	return result;
+}
+
+void FrameArena::reset()
+{
+	if (blah_stats.bytes > blah_stats.peak_bytes)
+		blah_stats.peak_bytes = blah_stats.bytes;
+
+	blah_stats.last_frame_bytes = blah_stats.bytes;
+	blah_stats.bytes = 0;
+	blah_stats.allocations = 0;
+	blah_stats.frame++;
+
+	// merge the blocks, so next frame everything fits in a single block
+	if (blah_blocks.size() > 1)
+	{
+		size_t capacity = blah_stats.capacity;
+		dispose();
+		blah_add_block(capacity);
+	}
+
+	blah_block = 0;
+	blah_offset = 0;
+	blah_last_offset = 0;
+}
+
+void FrameArena::dispose()
+{
+	for (auto& it : blah_blocks)
+		Memory::free(it.data);
+
+	blah_blocks.dispose();
+	blah_block = 0;
+	blah_offset = 0;
+	blah_last_offset = 0;
+	blah_stats.capacity = 0;
+	blah_stats.blocks = 0;
+}
+
+void FrameArena::set_block_size(size_t size)
+{
+	BLAH_ASSERT(size > 0, "Block size must be larger than 0");
+	if (size > 0)
+		blah_block_size = size;
+}
+
+FrameArena::Stats FrameArena::stats()
+{
+	return blah_stats;
+}
@@ -114,6 +114,10 @@ ShaderRef Shader::create(const ShaderData& data)
 					BLAH_ASSERT(false, error.cstr());
 					return ShaderRef();
 				}
+
+		// intern uniform names so Materials can find them without string comparisons
+		for (auto& it : uniforms)
+			it.id = StringId(it.name);
 	}
 
 	return shader;
@@ -159,6 +163,12 @@ void Texture::set_data(const Color* data)
 		set_data((u8*)data);
 }
 
+void Texture::set_data(const Color* data, const Recti& rect)
+{
+	if (format() == TextureFormat::RGBA)
+		set_data((u8*)data, rect);
+}
+
 void Texture::get_data(Color* data)
 {
 	if (format() == TextureFormat::RGBA)
@@ -346,6 +356,29 @@ void Material::set_texture(int register_index, const TextureRef& texture)
 	m_textures[register_index] = texture;
 }
 
+void Material::set_texture(StringId name, const TextureRef& texture, int index)
+{
+	BLAH_ASSERT(m_shader, "Material Shader is invalid");
+
+	for (auto& uniform : m_shader->uniforms())
+	{
+		if (uniform.type != UniformType::Texture2D)
+			continue;
+
+		if (uniform.id == name)
+		{
+			if (uniform.register_index + index < m_textures.size())
+			{
+				m_textures[uniform.register_index + index] = texture;
+				return;
+			}
+			break;
+		}
+	}
+
+	Log::warn("No Texture Uniform '%s' at index [%i] exists", name.cstr(), index);
+}
+
 TextureRef Material::get_texture(const char* name, int index) const
 {
 	BLAH_ASSERT(m_shader, "Material Shader is invalid");
@@ -414,6 +447,29 @@ void Material::set_sampler(int register_index, const TextureSampler& sampler)
 	m_samplers[register_index] = sampler;
 }
 
+void Material::set_sampler(StringId name, const TextureSampler& sampler, int index)
+{
+	BLAH_ASSERT(m_shader, "Material Shader is invalid");
+
+	for (auto& uniform : m_shader->uniforms())
+	{
+		if (uniform.type != UniformType::Sampler2D)
+			continue;
+
+		if (uniform.id == name)
+		{
+			if (uniform.register_index + index < m_samplers.size())
+			{
+				m_samplers[uniform.register_index + index] = sampler;
+				return;
+			}
+			break;
+		}
+	}
+
+	Log::warn("No Texture Sampler Uniform '%s' at index [%i] exists", name.cstr(), index);
+}
+
 TextureSampler Material::get_sampler(const char* name, int index) const
 {
 	BLAH_ASSERT(m_shader, "Material Shader is invalid");
@@ -480,6 +536,38 @@ void Material::set_value(const char* name, const float* value, i64 length)
 	Log::warn("No Uniform '%s' exists", name);
 }
 
+void Material::set_value(StringId name, const float* value, i64 length)
+{
+	BLAH_ASSERT(m_shader, "Material Shader is invalid");
+	BLAH_ASSERT(length >= 0, "Length must be >= 0");
+
+	int offset = 0;
+	for (auto& uniform : m_shader->uniforms())
+	{
+		if (uniform.type == UniformType::Texture2D ||
+			uniform.type == UniformType::Sampler2D ||
+			uniform.type == UniformType::None)
+			continue;
+
+		if (uniform.id == name)
+		{
+			auto max = blah_calc_uniform_size(uniform);
+			if (length > max)
+			{
+				Log::warn("Exceeding length of Uniform '%s' (%i / %i)", name.cstr(), (int)length, max);
+				length = max;
+			}
+
+			memcpy(m_data.begin() + offset, value, sizeof(float) * length);
+			return;
+		}
+
+		offset += blah_calc_uniform_size(uniform);
+	}
+
+	Log::warn("No Uniform '%s' exists", name.cstr());
+}
+
 void Material::set_value(const char* name, float value)
 {
 	set_value(name, &value, 1);
@@ -583,6 +671,20 @@ bool Material::has_value(const char* name) const
 	return false;
 }
 
+bool Material::has_value(StringId name) const
+{
+	BLAH_ASSERT(m_shader, "Material Shader is invalid");
+
+	if (!name.empty())
+	{
+		for (auto& uniform : m_shader->uniforms())
+			if (uniform.id == name)
+				return true;
+	}
+
+	return false;
+}
+
 const Vector<TextureRef>& Material::textures() const
 {
 	return m_textures;
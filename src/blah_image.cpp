@@ -1,7 +1,24 @@
 #include <blah_image.h>
+#include <blah_time.h>
+#include "internal/blah_parallel.h"
+#include "internal/blah_internal.h"
+
+#ifndef BLAH_NO_THREADING
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#endif
 
 using namespace Blah;
 
+// stb allocations go through Blah's memory hooks
+#define STBI_MALLOC(size) Blah::Memory::alloc(size, Blah::Memory::default_alignment, Blah::Memory::Tag::Image)
+#define STBI_REALLOC(ptr, size) Blah::Memory::realloc(ptr, size)
+#define STBI_FREE(ptr) Blah::Memory::free(ptr)
+#define STBIW_MALLOC(size) Blah::Memory::alloc(size, Blah::Memory::default_alignment, Blah::Memory::Tag::Image)
+#define STBIW_REALLOC(ptr, size) Blah::Memory::realloc(ptr, size)
+#define STBIW_FREE(ptr) Blah::Memory::free(ptr)
+
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_ONLY_JPEG
 #define STBI_ONLY_PNG
@@ -38,6 +55,244 @@ namespace
 	{
 		((Stream*)context)->write((char*)data, size);
 	}
+
+	struct PngCrcTable
+	{
+		u32 values[256];
+
+		PngCrcTable()
+		{
+			for (u32 n = 0; n < 256; n++)
+			{
+				u32 c = n;
+				for (int k = 0; k < 8; k++)
+					c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+				values[n] = c;
+			}
+		}
+	};
+
+	u32 png_crc(u32 crc, const u8* data, size_t length)
+	{
+		static const PngCrcTable table;
+
+		for (size_t i = 0; i < length; i++)
+			crc = table.values[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+		return crc;
+	}
+
+	void png_put_u32(u8* dst, u32 value)
+	{
+		dst[0] = (u8)(value >> 24);
+		dst[1] = (u8)(value >> 16);
+		dst[2] = (u8)(value >> 8);
+		dst[3] = (u8)(value);
+	}
+
+	bool png_write_chunk(Stream& stream, const char* type, const u8* data, size_t length)
+	{
+		u8 header[8];
+		png_put_u32(header, (u32)length);
+		memcpy(header + 4, type, 4);
+
+		u8 footer[4];
+		u32 crc = png_crc(0xffffffffu, header + 4, 4);
+		crc = png_crc(crc, data, length);
+		png_put_u32(footer, crc ^ 0xffffffffu);
+
+		return
+			stream.write(header, 8) == 8 &&
+			(length == 0 || stream.write(data, length) == length) &&
+			stream.write(footer, 4) == 4;
+	}
+
+	u8 png_paeth(int a, int b, int c)
+	{
+		int p = a + b - c;
+		int pa = abs(p - a);
+		int pb = abs(p - b);
+		int pc = abs(p - c);
+
+		if (pa <= pb && pa <= pc)
+			return (u8)a;
+		if (pb <= pc)
+			return (u8)b;
+		return (u8)c;
+	}
+
+	// filters a row of 4-byte pixels. `prev` is the previous unfiltered row (all zeros for the first row).
+	void png_filter_row(PngFilter filter, const u8* row, const u8* prev, int length, u8* out)
+	{
+		constexpr int bpp = 4;
+
+		switch (filter)
+		{
+		case PngFilter::Adaptive:
+		case PngFilter::None:
+			memcpy(out, row, length);
+			break;
+		case PngFilter::Sub:
+			for (int i = 0; i < length; i++)
+				out[i] = (u8)(row[i] - (i >= bpp ? row[i - bpp] : 0));
+			break;
+		case PngFilter::Up:
+			for (int i = 0; i < length; i++)
+				out[i] = (u8)(row[i] - prev[i]);
+			break;
+		case PngFilter::Average:
+			for (int i = 0; i < length; i++)
+				out[i] = (u8)(row[i] - (((i >= bpp ? row[i - bpp] : 0) + prev[i]) >> 1));
+			break;
+		case PngFilter::Paeth:
+			for (int i = 0; i < length; i++)
+				out[i] = (u8)(row[i] - png_paeth(i >= bpp ? row[i - bpp] : 0, prev[i], i >= bpp ? prev[i - bpp] : 0));
+			break;
+		}
+	}
+
+	// wraps the data in uncompressed ("stored") deflate blocks
+	void png_zlib_store(const u8* data, size_t length, Vector<u8>& out)
+	{
+		constexpr size_t max_block = 65535;
+		size_t blocks = (length + max_block - 1) / max_block;
+		if (blocks == 0)
+			blocks = 1;
+
+		out.clear();
+		out.reserve((i64)(2 + blocks * 5 + length + 4));
+		out.push_back(0x78);
+		out.push_back(0x01);
+
+		u32 s1 = 1, s2 = 0;
+		size_t offset = 0;
+
+		do
+		{
+			size_t size = Calc::min(length - offset, max_block);
+			bool last = (offset + size >= length);
+
+			out.push_back(last ? 1 : 0);
+			out.push_back((u8)(size & 0xff));
+			out.push_back((u8)(size >> 8));
+			out.push_back((u8)(~size & 0xff));
+			out.push_back((u8)((~size >> 8) & 0xff));
+
+			u8* dst = out.expand((int)size);
+			memcpy(dst, data + offset, size);
+
+			// adler32, with the modulo deferred as long as it safely can be
+			for (size_t i = 0; i < size; i++)
+			{
+				s1 += data[offset + i];
+				s2 += s1;
+				if ((i & 4095) == 4095)
+				{
+					s1 %= 65521;
+					s2 %= 65521;
+				}
+			}
+			s1 %= 65521;
+			s2 %= 65521;
+
+			offset += size;
+		} while (offset < length);
+
+		u8* adler = out.expand(4);
+		png_put_u32(adler, (s2 << 16) | s1);
+	}
+
+#ifndef BLAH_NO_THREADING
+	struct PngSaveJob
+	{
+		Image image;
+		FilePath path;
+		int compression_level = 0;
+		PngFilter filter = PngFilter::None;
+		Func<void, bool> on_complete;
+	};
+
+	// runs async png saves, one at a time, on a single background thread
+	class PngSaveQueue
+	{
+	public:
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable idle;
+		std::thread worker;
+		Vector<PngSaveJob> jobs;
+		bool busy = false;
+		bool stopping = false;
+
+		void push(PngSaveJob&& job)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.push_back(std::move(job));
+
+			if (!worker.joinable())
+				worker = std::thread([this]() { run(); });
+
+			wake.notify_one();
+		}
+
+		void wait()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			idle.wait(lock, [this]() { return jobs.size() <= 0 && !busy; });
+		}
+
+		// finishes every queued save and stops the worker thread.
+		// this is called when the App shuts down, while files can still be opened.
+		void shutdown()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+				wake.notify_one();
+			}
+
+			if (worker.joinable())
+				worker.join();
+
+			stopping = false;
+		}
+
+		~PngSaveQueue()
+		{
+			shutdown();
+		}
+
+	private:
+		void run()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			while (true)
+			{
+				wake.wait(lock, [this]() { return jobs.size() > 0 || stopping; });
+				if (jobs.size() <= 0)
+					break;
+
+				PngSaveJob job = std::move(jobs[0]);
+				jobs.erase(0);
+				busy = true;
+				lock.unlock();
+
+				bool result = job.image.save_png(job.path, job.compression_level, job.filter);
+				if (!result)
+					Log::warn("Failed to save image '%s'", job.path.cstr());
+				if (job.on_complete)
+					job.on_complete(result);
+
+				lock.lock();
+				busy = false;
+				if (jobs.size() <= 0)
+					idle.notify_all();
+			}
+		}
+	};
+
+	PngSaveQueue g_png_save_queue;
+#endif
 }
 
 Image::Image()
@@ -61,7 +316,7 @@ Image::Image(const FilePath& file)
 	pixels = nullptr;
 	m_stbi_ownership = false;
 
-	FileStream fs(file, FileMode::OpenRead);
+	MappedFileStream fs(file);
 	if (fs.is_readable())
 		from_stream(fs);
 }
@@ -72,7 +327,7 @@ Image::Image(int w, int h)
 
 	width = w;
 	height = h;
-	pixels = new Color[width * height];
+	pixels = (Color*)Memory::alloc(sizeof(Color) * width * height, alignof(Color), Memory::Tag::Image);
 	m_stbi_ownership = false;
 	memset(pixels, 0, (size_t)width * (size_t)height * sizeof(Color));
 }
@@ -86,7 +341,7 @@ Image::Image(const Image& src)
 
 	if (src.pixels != nullptr && width > 0 && height > 0)
 	{
-		pixels = new Color[width * height];
+		pixels = (Color*)Memory::alloc(sizeof(Color) * width * height, alignof(Color), Memory::Tag::Image);
 		memcpy(pixels, src.pixels, sizeof(Color) * width * height);
 	}
 }
@@ -102,7 +357,7 @@ Image& Image::operator=(const Image& src)
 
 	if (src.pixels != nullptr && width > 0 && height > 0)
 	{
-		pixels = new Color[width * height];
+		pixels = (Color*)Memory::alloc(sizeof(Color) * width * height, alignof(Color), Memory::Tag::Image);
 		memcpy(pixels, src.pixels, sizeof(Color) * width * height);
 	}
 
@@ -146,6 +401,14 @@ bool Image::from_stream(Stream& stream)
 	if (!stream.is_readable())
 		return false;
 
+	// decode in place if the stream's contents are already in memory
+	if (auto data = stream.data())
+	{
+		auto position = stream.position();
+		stream.seek(stream.length());
+		return from_memory(data + position, stream.length() - position);
+	}
+
 	stbi_io_callbacks callbacks;
 	callbacks.eof = blaH_stbi_eof;
 	callbacks.read = blah_stbi_read;
@@ -165,12 +428,72 @@ bool Image::from_stream(Stream& stream)
 	return true;
 }
 
+bool Image::from_memory(const u8* data, size_t length)
+{
+	dispose();
+
+	if (data == nullptr || length == 0 || length > INT32_MAX)
+		return false;
+
+	int x, y, comps;
+	u8* result = stbi_load_from_memory(data, (int)length, &x, &y, &comps, 4);
+
+	if (result == nullptr)
+		return false;
+
+	m_stbi_ownership = true;
+	pixels = (Color*)result;
+	width = x;
+	height = y;
+
+	return true;
+}
+
+Vector<ImageLoadResult> Image::load_many(const Vector<FilePath>& paths, int thread_count, const Func<void, const ImageLoadResult&>& on_loaded)
+{
+	Vector<ImageLoadResult> results;
+	results.expand(paths.size());
+
+#ifndef BLAH_NO_THREADING
+	std::mutex callback_mutex;
+#endif
+
+	Internal::parallel_for(paths.size(), thread_count, [&](int index)
+	{
+		auto& result = results[index];
+		result.index = index;
+		result.path = paths[index];
+
+		// map the entire file up front, so decoding doesn't go through the stream callbacks
+		u64 start = Time::get_ticks();
+		MappedFileStream stream(result.path);
+
+		if (stream.is_readable() && stream.length() > 0)
+			result.success = result.image.from_memory(stream.data(), stream.length());
+
+		result.load_ticks = Time::get_ticks() - start;
+
+		if (!result.success)
+			Log::warn("Unable to load image '%s'", result.path.cstr());
+
+		if (on_loaded)
+		{
+#ifndef BLAH_NO_THREADING
+			std::lock_guard<std::mutex> lock(callback_mutex);
+#endif
+			on_loaded(result);
+		}
+	});
+
+	return results;
+}
+
 void Image::dispose()
 {
 	if (m_stbi_ownership)
 		stbi_image_free(pixels);
 	else
-		delete[] pixels;
+		Memory::free(pixels);
 
 	pixels = nullptr;
 	width = height = 0;
@@ -200,27 +523,159 @@ void Image::set_pixels(const Recti& rect, Color* data)
 	}
 }
 
-bool Image::save_png(const FilePath& file) const
+bool Image::save_png(const FilePath& file, int compression_level, PngFilter filter) const
 {
 	FileStream fs(file, FileMode::CreateWrite);
-	return save_png(fs);
+	return save_png(fs, compression_level, filter);
 }
 
-bool Image::save_png(Stream& stream) const
+bool Image::save_png(Stream& stream, int compression_level, PngFilter filter) const
 {
 	BLAH_ASSERT(pixels != nullptr, "Image Pixel data cannot be null");
 	BLAH_ASSERT(width > 0 && height > 0, "Image Width and Height must be larger than 0");
-	
-	if (stream.is_writable())
+
+	if (compression_level < 0 || compression_level > 9)
 	{
-		stbi_write_force_png_filter = 0;
-		stbi_write_png_compression_level = 0;
+		Log::warn("png compression level should be between 0 and 9; input was %i", compression_level);
+		compression_level = Calc::clamp(compression_level, 0, 9);
+	}
 
-		if (stbi_write_png_to_func(blah_stbi_write, &stream, width, height, 4, pixels, width * 4) != 0)
-			return true;
+	if (!stream.is_writable())
+		return false;
+
+	// The PNG is assembled here rather than with stbi_write_png, as that is configured
+	// through global variables (which isn't safe with saves running on other threads)
+	// and it has no way to skip compression entirely.
+
+	const int row_length = width * 4;
+	const size_t filtered_length = (size_t)(row_length + 1) * (size_t)height;
+
+	if (filtered_length > INT32_MAX)
+	{
+		Log::error("Image is too large to save as a png");
+		return false;
 	}
 
-	return false;
+	// filter each row
+	Vector<u8> filtered;
+	Vector<u8> zero_row;
+	Vector<u8> scratch;
+	filtered.expand((int)filtered_length);
+	zero_row.expand(row_length);
+
+	if (filter == PngFilter::Adaptive)
+		scratch.expand(row_length);
+
+	for (int y = 0; y < height; y++)
+	{
+		const u8* row = (const u8*)(pixels + y * width);
+		const u8* prev = (y > 0 ? (const u8*)(pixels + (y - 1) * width) : zero_row.data());
+		u8* out = filtered.data() + (size_t)y * (row_length + 1);
+
+		PngFilter row_filter = filter;
+
+		// estimate the best filter by picking the one with the smallest sum of (signed) values
+		if (filter == PngFilter::Adaptive)
+		{
+			int best_sum = INT32_MAX;
+
+			for (int f = (int)PngFilter::None; f <= (int)PngFilter::Paeth; f++)
+			{
+				png_filter_row((PngFilter)f, row, prev, row_length, scratch.data());
+
+				int sum = 0;
+				for (int i = 0; i < row_length; i++)
+					sum += abs((i8)scratch[i]);
+
+				if (sum < best_sum)
+				{
+					best_sum = sum;
+					row_filter = (PngFilter)f;
+				}
+			}
+		}
+
+		out[0] = (u8)row_filter;
+		png_filter_row(row_filter, row, prev, row_length, out + 1);
+	}
+
+	// compress
+	Vector<u8> stored;
+	const u8* zlib_data = nullptr;
+	int zlib_length = 0;
+	u8* compressed = nullptr;
+
+	if (compression_level == 0)
+	{
+		png_zlib_store(filtered.data(), filtered_length, stored);
+		zlib_data = stored.data();
+		zlib_length = stored.size();
+	}
+	else
+	{
+		compressed = stbi_zlib_compress(filtered.data(), (int)filtered_length, &zlib_length, compression_level);
+		zlib_data = compressed;
+	}
+
+	filtered.dispose();
+
+	if (zlib_data == nullptr)
+		return false;
+
+	// write the file
+	static const u8 signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+	u8 header[13];
+	png_put_u32(header + 0, (u32)width);
+	png_put_u32(header + 4, (u32)height);
+	header[8] = 8;  // bit depth
+	header[9] = 6;  // color type (RGBA)
+	header[10] = 0; // compression method
+	header[11] = 0; // filter method
+	header[12] = 0; // interlace method
+
+	bool result =
+		stream.write(signature, 8) == 8 &&
+		png_write_chunk(stream, "IHDR", header, 13) &&
+		png_write_chunk(stream, "IDAT", zlib_data, zlib_length) &&
+		png_write_chunk(stream, "IEND", nullptr, 0);
+
+	if (compressed != nullptr)
+		STBIW_FREE(compressed);
+
+	return result;
+}
+
+void Image::save_png_async(Image&& image, const FilePath& file, int compression_level, PngFilter filter, const Func<void, bool>& on_complete)
+{
+#ifndef BLAH_NO_THREADING
+	PngSaveJob job;
+	job.image = std::move(image);
+	job.path = file;
+	job.compression_level = compression_level;
+	job.filter = filter;
+	job.on_complete = on_complete;
+	g_png_save_queue.push(std::move(job));
+#else
+	Image owned = std::move(image);
+	bool result = owned.save_png(file, compression_level, filter);
+	if (on_complete)
+		on_complete(result);
+#endif
+}
+
+void Image::wait_for_async_saves()
+{
+#ifndef BLAH_NO_THREADING
+	g_png_save_queue.wait();
+#endif
+}
+
+void Internal::image_shutdown()
+{
+#ifndef BLAH_NO_THREADING
+	g_png_save_queue.shutdown();
+#endif
 }
 
 bool Image::save_jpg(const FilePath& file, int quality) const
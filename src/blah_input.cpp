@@ -3,6 +3,7 @@
 #include <blah_time.h>
 #include <blah_common.h>
 #include <blah_calc.h>
+#include <blah_slotmap.h>
 #include "internal/blah_internal.h"
 #include "internal/blah_platform.h"
 
@@ -12,9 +13,9 @@ namespace
 {
 	InputState g_empty_state;
 	ControllerState g_empty_controller;
-	Vector<Ref<ButtonBinding>> g_buttons;
-	Vector<Ref<AxisBinding>> g_axes;
-	Vector<Ref<StickBinding>> g_sticks;
+	SlotMap<Ref<ButtonBinding>> g_buttons;
+	SlotMap<Ref<AxisBinding>> g_axes;
+	SlotMap<Ref<StickBinding>> g_sticks;
 	String g_clipboard;
 }
 
@@ -32,9 +33,9 @@ void Internal::input_init()
 
 	Input::last_state = g_empty_state;
 	Input::state = g_empty_state;
-	g_buttons = Vector<Ref<ButtonBinding>>();
-	g_axes = Vector<Ref<AxisBinding>>();
-	g_sticks = Vector<Ref<StickBinding>>();
+	g_buttons = SlotMap<Ref<ButtonBinding>>();
+	g_axes = SlotMap<Ref<AxisBinding>>();
+	g_sticks = SlotMap<Ref<StickBinding>>();
 }
 
 void Internal::input_shutdown()
@@ -83,44 +84,45 @@ void Internal::input_step_state()
 
 void Internal::input_step_bindings()
 {
-	for (int i = 0; i < g_buttons.size(); i++)
+	// removing a binding moves the last one into its place, so the index is checked again
+	for (i64 i = 0; i < g_buttons.size(); i++)
 	{
 		// we're the only user, so remove it
-		if (g_buttons[i].use_count() <= 1)
+		if (g_buttons.data()[i].use_count() <= 1)
 		{
-			g_buttons.erase(i);
+			g_buttons.remove(g_buttons.handle_at(i));
 			i--;
 		}
 		// keep updating
 		else
 		{
-			g_buttons[i]->update();
+			g_buttons.data()[i]->update();
 		}
 	}
 
-	for (int i = 0; i < g_axes.size(); i++)
+	for (i64 i = 0; i < g_axes.size(); i++)
 	{
-		if (g_axes[i].use_count() <= 1)
+		if (g_axes.data()[i].use_count() <= 1)
 		{
-			g_axes.erase(i);
+			g_axes.remove(g_axes.handle_at(i));
 			i--;
 		}
 		else
 		{
-			g_axes[i]->update();
+			g_axes.data()[i]->update();
 		}
 	}
 
-	for (int i = 0; i < g_sticks.size(); i++)
+	for (i64 i = 0; i < g_sticks.size(); i++)
 	{
-		if (g_sticks[i].use_count() <= 1)
+		if (g_sticks.data()[i].use_count() <= 1)
 		{
-			g_sticks.erase(i);
+			g_sticks.remove(g_sticks.handle_at(i));
 			i--;
 		}
 		else
 		{
-			g_sticks[i]->update();
+			g_sticks.data()[i]->update();
 		}
 	}
 }
@@ -404,21 +406,21 @@ void Input::set_clipboard(const String& text)
 ButtonBindingRef Input::register_binding(const ButtonBinding& binding_data)
 {
 	auto result = Ref<ButtonBinding>(new ButtonBinding(binding_data));
-	g_buttons.push_back(result);
+	g_buttons.add(result);
 	return result;
 }
 
 AxisBindingRef Input::register_binding(const AxisBinding& binding_data)
 {
 	auto result = Ref<AxisBinding>(new AxisBinding(binding_data));
-	g_axes.push_back(result);
+	g_axes.add(result);
 	return result;
 }
 
 StickBindingRef Input::register_binding(const StickBinding& binding_data)
 {
 	auto result = Ref<StickBinding>(new StickBinding(binding_data));
-	g_sticks.push_back(result);
+	g_sticks.add(result);
 	return result;
 }
 
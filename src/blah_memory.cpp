@@ -0,0 +1,272 @@
+#include <blah_memory.h>
+#include <string.h> // for memcpy
+
+#ifdef _WIN32
+#include <malloc.h> // for _aligned_malloc
+#endif
+
+#ifndef BLAH_NO_THREADING
+#include <atomic>
+#endif
+
+using namespace Blah;
+
+namespace
+{
+	// Stored just before every allocation, so it can be freed & tracked without knowing its size
+	struct Header
+	{
+		size_t size;
+		u16 offset;
+		u8 tag;
+		u8 hooks;
+	};
+
+	// allocations are offset from their base by at least this much, which also keeps them aligned
+	constexpr size_t header_size = 16;
+	static_assert(sizeof(Header) <= header_size, "Memory Header is too large");
+
+	constexpr int max_hooks = 16;
+	constexpr size_t max_alignment = 32768;
+
+	void* blah_default_alloc(size_t size, size_t alignment, void*)
+	{
+#ifdef _WIN32
+		return _aligned_malloc(size, alignment);
+#else
+		if (alignment <= Memory::default_alignment)
+			return ::malloc(size);
+
+		void* ptr = nullptr;
+		if (posix_memalign(&ptr, alignment, size) != 0)
+			return nullptr;
+		return ptr;
+#endif
+	}
+
+	void* blah_default_realloc(void* ptr, size_t size, size_t alignment, void*)
+	{
+#ifdef _WIN32
+		return _aligned_realloc(ptr, size, alignment);
+#else
+		// only called for default-aligned allocations, which realloc already keeps aligned
+		(void)alignment;
+		return ::realloc(ptr, size);
+#endif
+	}
+
+	void blah_default_free(void* ptr, void*)
+	{
+#ifdef _WIN32
+		_aligned_free(ptr);
+#else
+		::free(ptr);
+#endif
+	}
+
+	// every set of hooks is kept, so memory is always freed with the hooks that allocated it
+	Memory::Hooks blah_hooks[max_hooks] = {
+		{ blah_default_alloc, blah_default_realloc, blah_default_free, nullptr }
+	};
+
+#ifndef BLAH_NO_THREADING
+	using Counter = std::atomic<size_t>;
+	std::atomic<int> blah_hooks_count(1);
+	std::atomic<int> blah_hooks_current(0);
+	thread_local Memory::Tag blah_current_tag = Memory::Tag::General;
+#else
+	using Counter = size_t;
+	int blah_hooks_count = 1;
+	int blah_hooks_current = 0;
+	Memory::Tag blah_current_tag = Memory::Tag::General;
+#endif
+
+	struct TagCounters
+	{
+		Counter bytes;
+		Counter peak_bytes;
+		Counter allocations;
+		Counter total_allocations;
+	};
+
+	TagCounters blah_counters[(int)Memory::Tag::Count];
+
+	Header* blah_header(void* ptr)
+	{
+		return (Header*)((u8*)ptr - header_size);
+	}
+
+	void blah_track_alloc(u8 tag, size_t size)
+	{
+		auto& counters = blah_counters[tag];
+		size_t bytes = (counters.bytes += size);
+		counters.allocations++;
+		counters.total_allocations++;
+
+#ifndef BLAH_NO_THREADING
+		size_t peak = counters.peak_bytes.load();
+		while (bytes > peak && !counters.peak_bytes.compare_exchange_weak(peak, bytes)) {}
+#else
+		if (bytes > counters.peak_bytes)
+			counters.peak_bytes = bytes;
+#endif
+	}
+
+	void blah_track_free(u8 tag, size_t size)
+	{
+		auto& counters = blah_counters[tag];
+		counters.bytes -= size;
+		counters.allocations--;
+	}
+}
+
+bool Memory::set_hooks(const Hooks& hooks)
+{
+	BLAH_ASSERT(hooks.alloc && hooks.free, "Memory hooks must have an alloc and free function");
+	if (!hooks.alloc || !hooks.free)
+		return false;
+
+	int index = blah_hooks_count++;
+	if (index >= max_hooks)
+	{
+		Log::error("Unable to set Memory hooks, as they've been set too many times");
+		return false;
+	}
+
+	blah_hooks[index] = hooks;
+	blah_hooks_current = index;
+	return true;
+}
+
+void* Memory::alloc(size_t size, size_t alignment)
+{
+	return alloc(size, alignment, blah_current_tag);
+}
+
+void* Memory::alloc(size_t size, size_t alignment, Tag tag)
+{
+	BLAH_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of 2");
+	BLAH_ASSERT(alignment <= max_alignment, "Alignment is too large");
+	BLAH_ASSERT(tag >= Tag::General && tag < Tag::Count, "Invalid Memory Tag");
+
+	// the header is stored in the padding before the returned pointer
+	if (alignment < header_size)
+		alignment = header_size;
+
+	if (size > SIZE_MAX - alignment)
+		return nullptr;
+
+	int hooks_index = blah_hooks_current;
+	auto& hooks = blah_hooks[hooks_index];
+
+	auto base = (u8*)hooks.alloc(size + alignment, alignment, hooks.user);
+	if (base == nullptr)
+		return nullptr;
+
+	auto ptr = base + alignment;
+	auto header = blah_header(ptr);
+	header->size = size;
+	header->offset = (u16)alignment;
+	header->tag = (u8)tag;
+	header->hooks = (u8)hooks_index;
+
+	blah_track_alloc(header->tag, size);
+	return ptr;
+}
+
+void* Memory::realloc(void* ptr, size_t size)
+{
+	if (ptr == nullptr)
+		return alloc(size);
+
+	Header prev = *blah_header(ptr);
+	auto& hooks = blah_hooks[prev.hooks];
+
+	if (size > SIZE_MAX - prev.offset)
+		return nullptr;
+
+	// realloc can't keep larger alignments, so those are moved instead
+	if (hooks.realloc && prev.offset <= default_alignment)
+	{
+		auto base = (u8*)hooks.realloc((u8*)ptr - prev.offset, size + prev.offset, prev.offset, hooks.user);
+		if (base == nullptr)
+			return nullptr;
+
+		auto result = base + prev.offset;
+		blah_header(result)->size = size;
+		blah_track_free(prev.tag, prev.size);
+		blah_track_alloc(prev.tag, size);
+		return result;
+	}
+
+	auto result = alloc(size, prev.offset, (Tag)prev.tag);
+	if (result == nullptr)
+		return nullptr;
+
+	memcpy(result, ptr, (size < prev.size ? size : prev.size));
+	free(ptr);
+	return result;
+}
+
+void Memory::free(void* ptr)
+{
+	if (ptr == nullptr)
+		return;
+
+	auto header = blah_header(ptr);
+	auto& hooks = blah_hooks[header->hooks];
+
+	blah_track_free(header->tag, header->size);
+	hooks.free((u8*)ptr - header->offset, hooks.user);
+}
+
+Memory::Stats Memory::stats(Tag tag)
+{
+	BLAH_ASSERT(tag >= Tag::General && tag < Tag::Count, "Invalid Memory Tag");
+
+	auto& counters = blah_counters[(int)tag];
+
+	Stats result;
+	result.bytes = counters.bytes;
+	result.peak_bytes = counters.peak_bytes;
+	result.allocations = counters.allocations;
+	result.total_allocations = counters.total_allocations;
+	return result;
+}
+
+const char* Memory::tag_name(Tag tag)
+{
+	switch (tag)
+	{
+	case Tag::General: return "General";
+	case Tag::String: return "String";
+	case Tag::Image: return "Image";
+	case Tag::Font: return "Font";
+	case Tag::Audio: return "Audio";
+	case Tag::Stream: return "Stream";
+	case Tag::Graphics: return "Graphics";
+	case Tag::User0: return "User0";
+	case Tag::User1: return "User1";
+	case Tag::User2: return "User2";
+	case Tag::User3: return "User3";
+	case Tag::Count: break;
+	}
+
+	return "Unknown";
+}
+
+Memory::Tag Memory::current_tag()
+{
+	return blah_current_tag;
+}
+
+Memory::TagScope::TagScope(Tag tag)
+	: m_previous(blah_current_tag)
+{
+	blah_current_tag = tag;
+}
+
+Memory::TagScope::~TagScope()
+{
+	blah_current_tag = m_previous;
+}
@@ -40,7 +40,7 @@ void Packer::add_entry(u64 id, int w, int h, const Color* pixels, const Recti& s
 
 	// TOP:
 	for (int y = source.y; y < source.y + source.h; y++)
-		for (int x = source.x, s = x + y * w; x < source.x + source.w; x++, s++)
+		for (i64 x = source.x, s = x + (i64)y * w; x < source.x + source.w; x++, s++)
 			if (pixels[s].a > 0)
 			{
 				top = y;
@@ -48,7 +48,7 @@ void Packer::add_entry(u64 id, int w, int h, const Color* pixels, const Recti& s
 			}
 JUMP_LEFT:
 	for (int x = source.x; x < source.x + source.w; x++)
-		for (int y = top, s = x + y * w; y < source.y + source.h; y++, s += w)
+		for (i64 y = top, s = x + y * w; y < source.y + source.h; y++, s += w)
 			if (pixels[s].a > 0)
 			{
 				left = x;
@@ -56,7 +56,7 @@ JUMP_LEFT:
 			}
 JUMP_RIGHT:
 	for (int x = source.x + source.w - 1; x >= left; x--)
-		for (int y = top, s = x + y * w; y < source.y + source.h; y++, s += w)
+		for (i64 y = top, s = x + y * w; y < source.y + source.h; y++, s += w)
 			if (pixels[s].a > 0)
 			{
 				right = x + 1;
@@ -64,7 +64,7 @@ JUMP_RIGHT:
 			}
 JUMP_BOTTOM:
 	for (int y = source.y + source.h - 1; y >= top; y--)
-		for (int x = left, s = x + y * w; x < right; x++, s++)
+		for (i64 x = left, s = x + (i64)y * w; x < right; x++, s++)
 			if (pixels[s].a > 0)
 			{
 				bottom = y + 1;
@@ -87,14 +87,25 @@ JUMP_END:;
 		entry.memory_index = m_buffer.position();
 
 		// copy pixels over
+		size_t length = sizeof(Color) * (size_t)entry.packed.w * (size_t)entry.packed.h;
+		size_t written = 0;
+
 		if (entry.packed.w == w && entry.packed.h == h)
 		{
-			m_buffer.write((char*)pixels, sizeof(Color) * w * h);
+			written = m_buffer.write((char*)pixels, length);
 		}
 		else
 		{
 			for (int i = 0; i < entry.packed.h; i++)
-				m_buffer.write((char*)(pixels + left + (top + i) * w), sizeof(Color) * entry.packed.w);
+				written += m_buffer.write((char*)(pixels + left + (size_t)(top + i) * w), sizeof(Color) * entry.packed.w);
+		}
+
+		// the buffer couldn't hold the pixels
+		if (written != length)
+		{
+			Log::error("Unable to store the pixels of a Packer entry");
+			m_buffer.seek((size_t)entry.memory_index);
+			entry.empty = true;
 		}
 	}
 
@@ -1,5 +1,9 @@
 #include <blah_spritefont.h>
 #include <blah_packer.h>
+#include <blah_time.h>
+#include "internal/blah_parallel.h"
+#include <string.h> // for memcpy
+#include <algorithm>
 
 using namespace Blah;
 
@@ -37,37 +41,21 @@ void SpriteFont::clear()
 	m_atlas.clear();
 	m_characters.clear();
 	m_kerning.clear();
+	m_character_lookup.clear();
+	m_kerning_lookup.clear();
+	for (auto& it : m_direct_lookup)
+		it = 0;
+	m_cells.clear();
+	m_cell_buffer.clear();
+	m_font.reset();
+	m_sdf_spread = 0;
+	m_build_stats = BuildStats();
 	name.clear();
 }
 
 float SpriteFont::width_of(const String& text) const
 {
-	float width = 0;
-	float line_width = 0;
-
-	Codepoint last = 0;
-
-	Utf8 utf8(text.cstr());
-	while (utf8.character)
-	{
-		if (utf8.character == '\n')
-		{
-			line_width = 0;
-		}
-		else
-		{
-			line_width += get_character(utf8.character).advance;
-			if (last)
-				line_width += get_kerning(last, utf8.character);
-			if (line_width > width)
-				width = line_width;
-			last = utf8.character;
-		}
-
-		utf8.next();
-	}
-
-	return width;
+	return measure(text.cstr(), false, nullptr).x;
 }
 
 float SpriteFont::width_of_line(const String& text, int start) const
@@ -75,23 +63,7 @@ float SpriteFont::width_of_line(const String& text, int start) const
 	if (start < 0) return 0;
 	if (start >= text.length()) return 0;
 
-	float width = 0;
-	Codepoint last = 0;
-
-	Utf8 utf8(text.cstr());
-	while (utf8.character)
-	{
-		if (utf8.character == '\n')
-			break;
-
-		width += get_character(utf8.character).advance;
-		if (last)
-			width += get_kerning(last, utf8.character);
-		last = utf8.character;
-		utf8.next();
-	}
-
-	return width;
+	return measure(text.cstr() + start, true, nullptr).x;
 }
 
 float SpriteFont::height_of(const String& text) const
@@ -99,17 +71,91 @@ float SpriteFont::height_of(const String& text) const
 	if (text.length() <= 0)
 		return 0;
 
-	float height = line_height();
+	// newlines can't be part of multi-byte characters, so there's no need to decode the string
+	int lines = 1;
+	for (auto it = text.cstr(); *it; it++)
+		if (*it == '\n')
+			lines++;
+
+	return lines * line_height() - line_gap;
+}
+
+SpriteFont::Measurement SpriteFont::measure(const String& text) const
+{
+	Measurement result;
+	measure(text, result);
+	return result;
+}
+
+void SpriteFont::measure(const String& text, Measurement& result) const
+{
+	result.line_widths.clear();
+	result.size = measure(text.cstr(), false, &result.line_widths);
+}
+
+void SpriteFont::measure(const String* texts, int count, Vec2f* sizes) const
+{
+	for (int i = 0; i < count; i++)
+		sizes[i] = measure(texts[i].cstr(), false, nullptr);
+}
+
+Vec2f SpriteFont::measure(const char* text, bool first_line_only, Vector<float>* line_widths) const
+{
+	if (text == nullptr || *text == '\0')
+		return Vec2f::zero;
+
+	// skip kerning lookups entirely if the font has none
+	bool has_kerning = (m_kerning.size() > 0 || m_font);
 
-	Utf8 utf8(text.cstr());
-	while (utf8.character)
+	float width = 0;
+	float line_width = 0;
+	int lines = 1;
+	Codepoint last = 0;
+
+	auto it = text;
+	while (*it)
 	{
-		if (utf8.character == '\n')
-			height += line_height();
-		utf8.next();
+		// ascii characters don't need to be decoded
+		Codepoint codepoint = (u8)*it;
+		if (codepoint < 0x80)
+		{
+			it++;
+		}
+		else
+		{
+			Utf8 utf8(it);
+			codepoint = utf8.character;
+			it += utf8.character_size;
+		}
+
+		if (codepoint == '\n')
+		{
+			if (first_line_only)
+				break;
+
+			if (line_widths)
+				line_widths->push_back(line_width);
+			if (line_width > width)
+				width = line_width;
+
+			line_width = 0;
+			last = 0;
+			lines++;
+			continue;
+		}
+
+		line_width += get_character(codepoint).advance;
+		if (has_kerning && last)
+			line_width += get_kerning(last, codepoint);
+		last = codepoint;
 	}
 
-	return height - line_gap;
+	if (line_widths)
+		line_widths->push_back(line_width);
+	if (line_width > width)
+		width = line_width;
+
+	return Vec2f(width, lines * line_height() - line_gap);
 }
 
 void SpriteFont::rebuild(const FilePath& file, float sz, const CharSet& charset)
@@ -121,11 +167,25 @@ void SpriteFont::rebuild(const FilePath& file, float sz, const CharSet& charset)
 }
 
 void SpriteFont::rebuild(const FontRef& font, float size, const CharSet& charset)
+{
+	build(font, size, charset, 0);
+}
+
+void SpriteFont::rebuild_sdf(const FontRef& font, float size, const CharSet& charset, int spread)
+{
+	BLAH_ASSERT(spread > 0, "SDF spread must be larger than 0");
+	build(font, size, charset, Calc::max(spread, 1));
+}
+
+void SpriteFont::build(const FontRef& font, float size, const CharSet& charset, int sdf_spread)
 {
 	clear();
 	if (!font)
 		return;
 
+	u64 build_start = Time::get_ticks();
+	m_sdf_spread = sdf_spread;
+
 	float scale = font->get_scale(size);
 
 	name = font->family_name();
@@ -134,49 +194,110 @@ void SpriteFont::rebuild(const FontRef& font, float size, const CharSet& charset
 	line_gap = font->line_gap() * scale;
 	this->size = size;
 
-	Packer packer;
-	packer.spacing = 0;
-	packer.padding = 1;
-	packer.max_size = 8192;
-	packer.power_of_two = true;
-	
-	Vector<Color> buffer;
-
+	// gather the codepoints in order, so the output doesn't depend on the charset's order or how threads are scheduled
+	Vector<Codepoint> codepoints;
 	for (auto& range : charset)
 	{
-		auto from = range.from;
-		auto to = range.to + 1;
+		BLAH_ASSERT(range.to >= range.from, "Charset Range must be in pairs of [min,max]");
+
+		for (auto i = range.from; i <= range.to; i++)
+			codepoints.push_back(i);
+	}
+
+	std::sort(codepoints.begin(), codepoints.end());
+	codepoints.resize((int)(std::unique(codepoints.begin(), codepoints.end()) - codepoints.begin()));
+
+	// rasterize the glyphs in parallel.
+	// the codepoints are split into chunks, and each chunk writes its images into its own buffer.
+	struct GlyphResult
+	{
+		Font::Character ch;
+		int chunk = 0;
+		int offset = 0;
+		bool has_image = false;
+	};
+
+	Vector<GlyphResult> results;
+	results.resize(codepoints.size());
+
+	// use a handful of chunks per thread so uneven glyph sizes balance out
+	// and don't spin up threads for small charsets
+	constexpr int min_glyphs_per_thread = 64;
+	int threads = Calc::clamp((int)(codepoints.size() / min_glyphs_per_thread), 1, Internal::thread_count(build_threads));
+	int chunk_count = Calc::min((int)codepoints.size(), threads * 4);
+
+	Vector<Vector<Color>> chunk_buffers;
+	chunk_buffers.resize(chunk_count);
+
+	u64 raster_start = Time::get_ticks();
 
-		BLAH_ASSERT(to >= from, "Charset Range must be in pairs of [min,max]");
+	Internal::parallel_for(chunk_count, threads, [&](int chunk)
+	{
+		auto& buffer = chunk_buffers[chunk];
+		int from = (int)((i64)codepoints.size() * chunk / chunk_count);
+		int to = (int)((i64)codepoints.size() * (chunk + 1) / chunk_count);
 
-		for (auto i = from; i < to; i++)
+		for (int i = from; i < to; i++)
 		{
-			auto glyph = font->get_glyph(i);
+			auto& result = results[i];
+
+			auto glyph = font->get_glyph(codepoints[i]);
 			if (glyph <= 0)
 				continue;
 
-			// add character
-			auto ch = font->get_character(glyph, scale);
-			auto& sfch = get_character(i);
-			sfch.codepoint = i;
-			sfch.advance = ch.advance;
-			sfch.offset = Vec2f(ch.offset_x, ch.offset_y);
+			result.ch = (sdf_spread > 0 ? font->get_sdf_character(glyph, scale, sdf_spread) : font->get_character(glyph, scale));
+			result.chunk = chunk;
+			result.offset = buffer.size();
 
-			// pack glyph
-			if (ch.has_glyph)
+			if (result.ch.has_glyph)
 			{
-				if (buffer.size() < ch.width * ch.height)
-					buffer.resize(ch.width * ch.height);
+				buffer.expand(result.ch.width * result.ch.height);
 
-				if (font->get_image(ch, buffer.data()))
-					packer.add(i, ch.width, ch.height, buffer.data());
+				auto* pixels = buffer.data() + result.offset;
+				result.has_image = (sdf_spread > 0 ?
+					font->get_sdf_image(result.ch, sdf_spread, pixels) :
+					font->get_image(result.ch, pixels));
+
+				if (!result.has_image)
+					buffer.resize(result.offset);
 			}
 		}
+	});
+
+	u64 pack_start = Time::get_ticks();
+
+	// add the characters & glyph images in codepoint order
+	Packer packer;
+	packer.spacing = 0;
+	packer.padding = 1;
+	packer.max_size = 8192;
+	packer.power_of_two = true;
+
+	for (int i = 0; i < codepoints.size(); i++)
+	{
+		auto& result = results[i];
+		if (result.ch.glyph <= 0)
+			continue;
+
+		auto& sfch = get_character(codepoints[i]);
+		sfch.codepoint = codepoints[i];
+		sfch.glyph = result.ch.glyph;
+		sfch.advance = result.ch.advance;
+		sfch.offset = Vec2f(result.ch.offset_x, result.ch.offset_y);
+
+		if (result.has_image)
+		{
+			packer.add(codepoints[i], result.ch.width, result.ch.height, chunk_buffers[result.chunk].data() + result.offset);
+			m_build_stats.glyph_count++;
+		}
 	}
 
-	buffer.clear();
+	chunk_buffers.dispose();
+	results.dispose();
 	packer.pack();
 
+	u64 upload_start = Time::get_ticks();
+
 	for (auto& it : packer.pages)
 		m_atlas.push_back(Texture::create(it));
 
@@ -185,125 +306,612 @@ void SpriteFont::rebuild(const FontRef& font, float size, const CharSet& charset
 		if (!it.empty)
 			get_character((Codepoint)it.id).subtexture = Subtexture(m_atlas[it.page], it.packed, it.frame);
 
+	u64 kerning_start = Time::get_ticks();
+
 	// add kerning
-	for (auto& a : m_characters)
+	Vector<Font::KerningPair> pairs;
+	if (font->get_kerning_pairs(pairs, scale))
 	{
-		for (auto& b : m_characters)
+		// the pairs are between glyphs, so map them back to codepoints.
+		// more than one codepoint can use the same glyph.
+		struct GlyphCodepoint { int glyph; Codepoint codepoint; };
+
+		Vector<GlyphCodepoint> glyphs;
+		glyphs.reserve(m_characters.size());
+		for (auto& it : m_characters)
+			if (it.glyph > 0)
+				glyphs.push_back({ it.glyph, it.codepoint });
+
+		auto by_glyph = [](const GlyphCodepoint& a, const GlyphCodepoint& b) { return a.glyph < b.glyph; };
+		std::sort(glyphs.begin(), glyphs.end(), by_glyph);
+
+		for (auto& pair : pairs)
 		{
-			auto kerning_value = font->get_kerning(a.glyph, b.glyph, scale);
-			if (kerning_value != 0)
-				set_kerning(a.codepoint, b.codepoint, kerning_value);
+			auto a = std::equal_range(glyphs.begin(), glyphs.end(), GlyphCodepoint{ pair.glyph1, 0 }, by_glyph);
+			if (a.first == a.second)
+				continue;
+
+			auto b = std::equal_range(glyphs.begin(), glyphs.end(), GlyphCodepoint{ pair.glyph2, 0 }, by_glyph);
+			for (auto i = a.first; i != a.second; i++)
+				for (auto j = b.first; j != b.second; j++)
+					set_kerning(i->codepoint, j->codepoint, pair.value);
 		}
 	}
+	else
+	{
+		// the pairs have to be checked one at a time, but only for glyphs that can start a pair
+		for (auto& a : m_characters)
+		{
+			if (a.glyph <= 0 || !font->has_kerning(a.glyph))
+				continue;
+
+			for (auto& b : m_characters)
+			{
+				if (b.glyph <= 0)
+					continue;
+
+				auto kerning_value = font->get_kerning(a.glyph, b.glyph, scale);
+				if (kerning_value != 0)
+					set_kerning(a.codepoint, b.codepoint, kerning_value);
+			}
+		}
+	}
+
+	u64 end = Time::get_ticks();
+	m_build_stats.thread_count = threads;
+	m_build_stats.raster_ticks = pack_start - raster_start;
+	m_build_stats.pack_ticks = upload_start - pack_start;
+	m_build_stats.upload_ticks = kerning_start - upload_start;
+	m_build_stats.kerning_ticks = end - kerning_start;
+	m_build_stats.total_ticks = end - build_start;
+}
+
+void SpriteFont::rebuild_dynamic(const FontRef& font, float size, int page_size, int max_pages)
+{
+	clear();
+	if (!font)
+		return;
+
+	BLAH_ASSERT(page_size > 0, "Page size must be larger than 0");
+	BLAH_ASSERT(max_pages > 0, "Max pages must be larger than 0");
+
+	m_scale = font->get_scale(size);
+
+	name = font->family_name();
+	ascent = font->ascent() * m_scale;
+	descent = font->descent() * m_scale;
+	line_gap = font->line_gap() * m_scale;
+	this->size = size;
+
+	// every cell is large enough to fit any glyph in the font, plus a pixel of padding on each side
+	auto bounds = font->bounding_box();
+	m_cell_size.x = (int)Calc::ceiling(bounds.w * m_scale) + 1 + 2;
+	m_cell_size.y = (int)Calc::ceiling(bounds.h * m_scale) + 1 + 2;
+
+	m_font = font;
+	m_page_size = Calc::max(page_size, Calc::max(m_cell_size.x, m_cell_size.y));
+	m_max_pages = max_pages;
+	m_cell_buffer.resize(m_cell_size.x * m_cell_size.y * 2);
 }
 
 namespace
 {
-	bool find_character_index(const Vector<SpriteFont::Character>& items, SpriteFont::Codepoint codepoint, int lower, int higher, int* index)
+	// SpriteFont binary format, all values are little endian:
+	// header:     "BLSF", u32 version
+	// metrics:    u32 name length, name, f32 size, f32 ascent, f32 descent, f32 line gap, i32 sdf spread
+	// pages:      u32 count, and for each: i32 width, i32 height, u8 encoding, pixels
+	// characters: u32 count, and for each: u32 codepoint, i32 glyph, f32 advance, f32 offset x & y,
+	//             i32 page (or -1), f32 source x, y, w, h, f32 frame x, y, w, h
+	// kerning:    u32 count, and for each: u32 codepoint a, u32 codepoint b, f32 value
+	constexpr u8 blah_spritefont_magic[4] = { 'B', 'L', 'S', 'F' };
+	constexpr u32 blah_spritefont_version = 1;
+
+	enum class PageEncoding : u8
 	{
-		while (lower <= higher)
+		// 4 bytes per pixel
+		RGBA = 0,
+
+		// 1 byte per pixel, for premultiplied white pixels where r = g = b = a
+		Gray = 1,
+
+		// 1 byte per pixel, for white pixels with alpha (ex. signed distance fields).
+		// fully transparent pixels are stored as transparent black.
+		Alpha = 2,
+	};
+
+	PageEncoding blah_page_encoding(const Vector<Color>& pixels)
+	{
+		bool gray = true;
+		bool alpha = true;
+
+		for (auto& it : pixels)
 		{
-			// found
-			int mid = (higher + lower) / 2;
-			if (items[mid].codepoint == codepoint)
-			{
-				*index = mid;
-				return true;
-			}
+			if (it.r != it.a || it.g != it.a || it.b != it.a)
+				gray = false;
+			if (it.a > 0 && (it.r != 255 || it.g != 255 || it.b != 255))
+				alpha = false;
+			if (!gray && !alpha)
+				return PageEncoding::RGBA;
+		}
+
+		return (gray ? PageEncoding::Gray : PageEncoding::Alpha);
+	}
 
-			// search upper / lower bounds
-			if (items[mid].codepoint < codepoint)
-				lower = mid + 1;
-			else
-				higher = mid - 1;
+	void blah_write_rect(Stream& stream, const Rectf& rect)
+	{
+		stream.write_f32(rect.x);
+		stream.write_f32(rect.y);
+		stream.write_f32(rect.w);
+		stream.write_f32(rect.h);
+	}
+
+	Rectf blah_read_rect(Stream& stream)
+	{
+		Rectf rect;
+		rect.x = stream.read_f32();
+		rect.y = stream.read_f32();
+		rect.w = stream.read_f32();
+		rect.h = stream.read_f32();
+		return rect;
+	}
+}
+
+bool SpriteFont::save(Stream& stream) const
+{
+	if (is_dynamic())
+	{
+		Log::error("Dynamic SpriteFonts can't be saved");
+		return false;
+	}
+
+	if (!stream.is_writable())
+	{
+		Log::error("Unable to save the SpriteFont as the Stream was not writable");
+		return false;
+	}
+
+	// the whole font is written to memory first, so it goes to the stream in a single write
+	BufferStream out;
+	out.write(blah_spritefont_magic, sizeof(blah_spritefont_magic));
+	out.write_u32(blah_spritefont_version);
+
+	// metrics
+	out.write_u32((u32)name.length());
+	out.write(name);
+	out.write_f32(size);
+	out.write_f32(ascent);
+	out.write_f32(descent);
+	out.write_f32(line_gap);
+	out.write_i32(m_sdf_spread);
+
+	// pages
+	Vector<Color> pixels;
+	Vector<u8> channel;
+
+	out.write_u32((u32)m_atlas.size());
+	for (auto& page : m_atlas)
+	{
+		int w = page->width();
+		int h = page->height();
+
+		pixels.resize(w * h);
+		page->get_data(pixels.data());
+
+		auto encoding = blah_page_encoding(pixels);
+		out.write_i32(w);
+		out.write_i32(h);
+		out.write_u8((u8)encoding);
+
+		if (encoding == PageEncoding::RGBA)
+		{
+			out.write(pixels.data(), sizeof(Color) * pixels.size());
 		}
+		else
+		{
+			channel.resize(pixels.size());
+			for (int i = 0; i < pixels.size(); i++)
+				channel[i] = pixels[i].a;
+			out.write(channel.data(), channel.size());
+		}
+	}
 
-		// not found
-		*index = lower;
+	// characters
+	out.write_u32((u32)m_characters.size());
+	for (auto& it : m_characters)
+	{
+		int page = -1;
+		for (int i = 0; i < m_atlas.size() && it.subtexture.texture; i++)
+			if (m_atlas[i] == it.subtexture.texture)
+				page = i;
+
+		out.write_u32(it.codepoint);
+		out.write_i32(it.glyph);
+		out.write_f32(it.advance);
+		out.write_f32(it.offset.x);
+		out.write_f32(it.offset.y);
+		out.write_i32(page);
+		blah_write_rect(out, it.subtexture.source);
+		blah_write_rect(out, it.subtexture.frame);
+	}
+
+	// kerning
+	out.write_u32((u32)m_kerning.size());
+	for (auto& it : m_kerning)
+	{
+		out.write_u32(it.a);
+		out.write_u32(it.b);
+		out.write_f32(it.value);
+	}
+
+	return stream.write(out.data(), out.length()) == out.length();
+}
+
+bool SpriteFont::save(const FilePath& path) const
+{
+	FileStream fs(path, FileMode::CreateWrite);
+	return save(fs);
+}
+
+bool SpriteFont::load(Stream& stream)
+{
+	clear();
+
+	if (!stream.is_readable())
+	{
+		Log::error("Unable to load the SpriteFont as the Stream was not readable");
 		return false;
 	}
 
-	bool find_kerning_index(const Vector<SpriteFont::Kerning>& items, SpriteFont::Codepoint a, SpriteFont::Codepoint b, int lower, int higher, int* index)
+	// load in place if the stream's contents are already in memory
+	if (auto data = stream.data())
 	{
-		while (lower <= higher)
+		auto position = stream.position();
+		stream.seek(stream.length());
+		return load(data + position, stream.length() - position);
+	}
+
+	Vector<u8> buffer;
+	buffer.resize((i64)(stream.length() - stream.position()));
+	buffer.resize((i64)stream.read(buffer.data(), (size_t)buffer.size()));
+	return load(buffer.data(), (size_t)buffer.size());
+}
+
+bool SpriteFont::load(const FilePath& path)
+{
+	clear();
+
+	MappedFileStream fs(path);
+	return load(fs);
+}
+
+bool SpriteFont::load(const u8* data, size_t length)
+{
+	MemoryStream stream(data, length);
+	auto remaining = [&]() { return stream.length() - stream.position(); };
+	auto fail = [&](const char* message)
+	{
+		Log::error("Unable to load the SpriteFont: %s", message);
+		clear();
+		return false;
+	};
+
+	// header
+	if (length < 8 || memcmp(data, blah_spritefont_magic, sizeof(blah_spritefont_magic)) != 0)
+		return fail("not a SpriteFont file");
+	stream.seek(sizeof(blah_spritefont_magic));
+	if (stream.read_u32() != blah_spritefont_version)
+		return fail("unsupported version");
+
+	// metrics
+	u32 name_length = stream.read_u32();
+	if (remaining() < (size_t)name_length + 20)
+		return fail("unexpected end of data");
+	name = stream.read_string((int)name_length);
+	size = stream.read_f32();
+	ascent = stream.read_f32();
+	descent = stream.read_f32();
+	line_gap = stream.read_f32();
+	m_sdf_spread = stream.read_i32();
+
+	// pages
+	Vector<Color> pixels;
+
+	if (remaining() < 4)
+		return fail("unexpected end of data");
+	u32 page_count = stream.read_u32();
+	for (u32 i = 0; i < page_count; i++)
+	{
+		if (remaining() < 9)
+			return fail("unexpected end of data");
+
+		int w = stream.read_i32();
+		int h = stream.read_i32();
+		auto encoding = (PageEncoding)stream.read_u8();
+
+		if (w <= 0 || h <= 0 || w > 65536 || h > 65536)
+			return fail("invalid page size");
+
+		size_t count = (size_t)w * h;
+		size_t bytes = count * (encoding == PageEncoding::RGBA ? sizeof(Color) : 1);
+		if (remaining() < bytes)
+			return fail("unexpected end of data");
+
+		const u8* src = data + stream.position();
+		stream.seek(stream.position() + bytes);
+
+		// RGBA pages are uploaded straight from the data
+		if (encoding == PageEncoding::RGBA)
 		{
-			// found
-			int mid = (higher + lower) / 2;
-			if (items[mid].a == a && items[mid].b == b)
-			{
-				*index = mid;
-				return true;
-			}
+			m_atlas.push_back(Texture::create(w, h, TextureFormat::RGBA, (unsigned char*)src));
+			continue;
+		}
 
-			// search upper / lower bounds
-			if (items[mid].a == a)
-			{
-				if (items[mid].b < b)
-					lower = mid + 1;
-				else
-					higher = mid - 1;
-			}
-			else if (items[mid].a < a)
-				lower = mid + 1;
-			else
-				higher = mid - 1;
+		pixels.resize((int)count);
+		if (encoding == PageEncoding::Gray)
+		{
+			for (size_t n = 0; n < count; n++)
+				pixels[n] = Color(src[n], src[n], src[n], src[n]);
+		}
+		else if (encoding == PageEncoding::Alpha)
+		{
+			for (size_t n = 0; n < count; n++)
+				pixels[n] = (src[n] > 0 ? Color(255, 255, 255, src[n]) : Color(0, 0, 0, 0));
+		}
+		else
+		{
+			return fail("invalid page encoding");
 		}
 
-		// not found
-		*index = lower;
-		return false;
+		m_atlas.push_back(Texture::create(w, h, TextureFormat::RGBA, (unsigned char*)pixels.data()));
+	}
+
+	// characters
+	constexpr size_t character_bytes = 4 * 14;
+
+	if (remaining() < 4)
+		return fail("unexpected end of data");
+	u32 character_count = stream.read_u32();
+	if (remaining() / character_bytes < character_count)
+		return fail("unexpected end of data");
+
+	m_characters.reserve((int)character_count);
+	for (u32 i = 0; i < character_count; i++)
+	{
+		auto codepoint = (Codepoint)stream.read_u32();
+		auto& ch = get_character(codepoint);
+		ch.glyph = stream.read_i32();
+		ch.advance = stream.read_f32();
+		ch.offset.x = stream.read_f32();
+		ch.offset.y = stream.read_f32();
+
+		int page = stream.read_i32();
+		auto source = blah_read_rect(stream);
+		auto frame = blah_read_rect(stream);
+
+		if (page >= m_atlas.size())
+			return fail("invalid character page");
+		if (page >= 0)
+			ch.subtexture = Subtexture(m_atlas[page], source, frame);
 	}
+
+	// kerning
+	if (remaining() < 4)
+		return fail("unexpected end of data");
+	u32 kerning_count = stream.read_u32();
+	if (remaining() / 12 < kerning_count)
+		return fail("unexpected end of data");
+
+	m_kerning.reserve((int)kerning_count);
+	for (u32 i = 0; i < kerning_count; i++)
+	{
+		auto a = (Codepoint)stream.read_u32();
+		auto b = (Codepoint)stream.read_u32();
+		set_kerning(a, b, stream.read_f32());
+	}
+
+	return true;
+}
+
+namespace
+{
+	u64 blah_kerning_key(SpriteFont::Codepoint a, SpriteFont::Codepoint b)
+	{
+		return ((u64)a << 32) | (u64)b;
+	}
+}
+
+int SpriteFont::find_character_index(Codepoint codepoint) const
+{
+	if (codepoint < direct_lookup_count)
+		return m_direct_lookup[codepoint] - 1;
+
+	auto index = m_character_lookup.find(codepoint);
+	return (index ? *index : -1);
+}
+
+int SpriteFont::add_character(Codepoint codepoint) const
+{
+	int index = m_characters.size();
+	m_characters.expand();
+	m_characters[index].codepoint = codepoint;
+
+	if (codepoint < direct_lookup_count)
+		m_direct_lookup[codepoint] = index + 1;
+	else
+		m_character_lookup.insert(codepoint, index);
+
+	return index;
 }
 
 float SpriteFont::get_kerning(Codepoint a, Codepoint b) const
 {
-	int index;
-	if (find_kerning_index(m_kerning, a, b, 0, m_kerning.size() - 1, &index))
-		return m_kerning[index].value;
+	if (auto index = m_kerning_lookup.find(blah_kerning_key(a, b)))
+		return m_kerning[*index].value;
+
+	// dynamic spritefonts don't know their characters ahead of time, so ask the font
+	if (m_font)
+	{
+		int glyph_a = find_character(a).glyph;
+		int glyph_b = find_character(b).glyph;
+		if (glyph_a > 0 && glyph_b > 0)
+			return m_font->get_kerning(glyph_a, glyph_b, m_scale);
+	}
+
 	return 0;
 }
 
 void SpriteFont::set_kerning(Codepoint a, Codepoint b, float value)
 {
-	int index;
-	if (find_kerning_index(m_kerning, a, b, 0, m_kerning.size() - 1, &index))
+	auto key = blah_kerning_key(a, b);
+
+	if (auto index = m_kerning_lookup.find(key))
 	{
-		m_kerning[index].value = value;
+		m_kerning[*index].value = value;
 	}
 	else
 	{
-		m_kerning.expand();
-		for (int i = m_kerning.size() - 1; i > index; i--)
-			m_kerning[i] = std::move(m_kerning[i - 1]);
-		m_kerning[index].a = a;
-		m_kerning[index].b = b;
-		m_kerning[index].value = value;
+		m_kerning_lookup.insert(key, (int)m_kerning.size());
+		m_kerning.push_back({ a, b, value });
 	}
 }
 
-SpriteFont::Character& SpriteFont::get_character(Codepoint codepoint)
+SpriteFont::Character& SpriteFont::find_character(Codepoint codepoint) const
 {
-	int index;
-	if (find_character_index(m_characters, codepoint, 0, m_characters.size() - 1, &index))
+	int index = find_character_index(codepoint);
+	if (index < 0)
 	{
-		return m_characters[index];
+		auto& sfch = m_characters[add_character(codepoint)];
+		sfch.glyph = m_font->get_glyph(codepoint);
+
+		if (sfch.glyph > 0)
+		{
+			auto ch = m_font->get_character(sfch.glyph, m_scale);
+			sfch.advance = ch.advance;
+			sfch.offset = Vec2f(ch.offset_x, ch.offset_y);
+			if (ch.has_glyph)
+				cache_glyph(sfch);
+		}
+
+		return sfch;
 	}
-	else
+
+	auto& sfch = m_characters[index];
+
+	// the glyph was evicted, so it needs to be rasterized again
+	if (sfch.cell < 0 && sfch.glyph > 0 && !sfch.subtexture.texture)
 	{
-		m_characters.expand();
-		for (int i = m_characters.size() - 1; i > index; i --)
-			m_characters[i] = std::move(m_characters[i - 1]);
-		m_characters[index].codepoint = codepoint;
-		return m_characters[index];
+		if (m_font->get_character(sfch.glyph, m_scale).has_glyph)
+			cache_glyph(sfch);
+	}
+	else if (sfch.cell >= 0)
+	{
+		m_cells[sfch.cell].last_used = ++m_cell_counter;
+		m_cells[sfch.cell].frame = Time::frames;
+	}
+
+	return sfch;
+}
+
+void SpriteFont::cache_glyph(Character& sfch) const
+{
+	auto ch = m_font->get_character(sfch.glyph, m_scale);
+	if (ch.width + 2 > m_cell_size.x || ch.height + 2 > m_cell_size.y)
+		return;
+
+	int columns = m_page_size / m_cell_size.x;
+	int cells_per_page = columns * (m_page_size / m_cell_size.y);
+	int cell = -1;
+
+	// once every page is full, evict the least recently used glyph. Glyphs that have been used this
+	// frame are never evicted, as they may already be in a Batch that hasn't been drawn yet.
+	if (m_cells.size() >= m_atlas.size() * cells_per_page && m_atlas.size() >= m_max_pages)
+	{
+		for (int i = 0; i < m_cells.size(); i++)
+		{
+			if (m_cells[i].frame == Time::frames)
+				continue;
+			if (cell < 0 || m_cells[i].last_used < m_cells[cell].last_used)
+				cell = i;
+		}
+
+		if (cell >= 0)
+		{
+			int index = find_character_index(m_cells[cell].codepoint);
+			if (index >= 0)
+			{
+				m_characters[index].subtexture = Subtexture();
+				m_characters[index].cell = -1;
+			}
+		}
+	}
+
+	// otherwise use the next free cell, adding a new page if needed.
+	// if every cell has been used this frame, this goes past max_pages.
+	if (cell < 0)
+	{
+		if (m_cells.size() >= m_atlas.size() * cells_per_page)
+			m_atlas.push_back(Texture::create(m_page_size, m_page_size, TextureFormat::RGBA));
+
+		cell = m_cells.size();
+		m_cells.expand();
 	}
+
+	auto& texture = m_atlas[cell / cells_per_page];
+	if (!texture)
+		return;
+
+	int local = cell % cells_per_page;
+	Recti bounds(
+		(local % columns) * m_cell_size.x,
+		(local / columns) * m_cell_size.y,
+		m_cell_size.x,
+		m_cell_size.y);
+
+	// rasterize the glyph into the cell, leaving a transparent border around it.
+	// the whole cell is uploaded so that anything previously in it is cleared out.
+	// (the first half of the buffer is the cell, and the second half is used for the glyph)
+	Color* pixels = m_cell_buffer.data();
+	Color* glyph = pixels + m_cell_size.x * m_cell_size.y;
+	if (!m_font->get_image(ch, glyph))
+		return;
+
+	for (int i = 0; i < m_cell_size.x * m_cell_size.y; i++)
+		pixels[i] = Color::transparent;
+
+	for (int y = 0; y < ch.height; y++)
+		memcpy(pixels + (y + 1) * m_cell_size.x + 1, glyph + y * ch.width, sizeof(Color) * ch.width);
+
+	texture->set_data(m_cell_buffer.data(), bounds);
+
+	m_cells[cell].codepoint = sfch.codepoint;
+	m_cells[cell].last_used = ++m_cell_counter;
+	m_cells[cell].frame = Time::frames;
+
+	sfch.cell = cell;
+	sfch.subtexture = Subtexture(texture, Rectf(bounds.x + 1.0f, bounds.y + 1.0f, (float)ch.width, (float)ch.height));
+}
+
+SpriteFont::Character& SpriteFont::get_character(Codepoint codepoint)
+{
+	if (m_font)
+		return find_character(codepoint);
+
+	int index = find_character_index(codepoint);
+	if (index < 0)
+		index = add_character(codepoint);
+
+	return m_characters[index];
 }
 
 const SpriteFont::Character& SpriteFont::get_character(Codepoint codepoint) const
 {
 	static const Character empty;
 
-	int index;
-	if (find_character_index(m_characters, codepoint, 0, m_characters.size() - 1, &index))
+	if (m_font)
+		return find_character(codepoint);
+
+	int index = find_character_index(codepoint);
+	if (index >= 0)
 		return m_characters[index];
 
 	return empty;
@@ -1,5 +1,6 @@
 #include <blah_stream.h>
 #include <blah_string.h>
+#include "internal/blah_platform.h"
 #include <string.h> // for memcpy
 
 using namespace Blah;
@@ -30,11 +31,6 @@ size_t Stream::pipe(Stream& stream, size_t length)
 	return result;
 }
 
-size_t Stream::read(void* buffer, size_t length)
-{
-	return read_data(buffer, length);
-}
-
 String Stream::read_string(int length)
 {
 	String result;
@@ -65,6 +61,11 @@ String Stream::read_line()
 	return result;
 }
 
+const u8* Stream::data() const
+{
+	return nullptr;
+}
+
 size_t Stream::write(const void* buffer, size_t length)
 {
 	return write_data(buffer, length);
@@ -75,166 +76,315 @@ size_t Stream::write(const String& string)
 	return write(string.begin(), string.length());
 }
 
-u8 Stream::read_u8(Endian endian)
+size_t Stream::write_u8(u8 value, Endian endian)
 {
-	u8 value; read_data(&value, sizeof(u8));
 	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return value;
+	return write_data(&value, sizeof(u8));
 }
 
-u16 Stream::read_u16(Endian endian)
+size_t Stream::write_u16(u16 value, Endian endian)
 {
-	u16 value; read_data(&value, sizeof(u16));
 	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return value;
+	return write_data(&value, sizeof(u16));
 }
 
-u32 Stream::read_u32(Endian endian)
+size_t Stream::write_u32(u32 value, Endian endian)
 {
-	u32 value; read_data(&value, sizeof(u32));
 	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return value;
+	return write_data(&value, sizeof(u32));
 }
 
-u64 Stream::read_u64(Endian endian)
+size_t Stream::write_u64(u64 value, Endian endian)
 {
-	u64 value; read_data(&value, sizeof(u64));
 	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return value;
+	return write_data(&value, sizeof(u64));
 }
 
-i8 Stream::read_i8(Endian endian)
+size_t Stream::write_i8(i8 value, Endian endian)
 {
-	i8 value; read_data(&value, sizeof(i8));
 	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return value;
+	return write_data(&value, sizeof(i8));
 }
 
-i16 Stream::read_i16(Endian endian)
+size_t Stream::write_i16(i16 value, Endian endian)
 {
-	i16 value; read_data(&value, sizeof(i16));
 	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return value;
+	return write_data(&value, sizeof(i16));
 }
 
-i32 Stream::read_i32(Endian endian)
+size_t Stream::write_i32(i32 value, Endian endian)
 {
-	i32 value; read_data(&value, sizeof(i32));
 	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return value;
+	return write_data(&value, sizeof(i32));
 }
 
-i64 Stream::read_i64(Endian endian)
+size_t Stream::write_i64(i64 value, Endian endian)
 {
-	i64 value; read_data(&value, sizeof(i64));
 	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return value;
+	return write_data(&value, sizeof(i64));
 }
 
-float  Stream::read_f32(Endian endian)
+size_t Stream::write_f32(float value, Endian endian)
 {
-	float value; read_data(&value, sizeof(float));
 	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return value;
+	return write_data(&value, sizeof(float));
 }
 
-double Stream::read_f64(Endian endian)
+size_t Stream::write_f64(double value, Endian endian)
 {
-	double value; read_data(&value, sizeof(double));
 	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return value;
+	return write_data(&value, sizeof(double));
 }
 
-size_t Stream::write_u8(u8 value, Endian endian)
+
+// Buffered Stream Implementation
+
+BufferedStream::BufferedStream(Stream& stream, size_t buffer_size)
+	: m_stream(&stream), m_buffer_size(buffer_size), m_origin(stream.position()) {}
+
+BufferedStream::~BufferedStream()
 {
-	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return write_data(&value, sizeof(u8));
+	flush();
 }
 
-size_t Stream::write_u16(u16 value, Endian endian)
+size_t BufferedStream::length() const
 {
-	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return write_data(&value, sizeof(u16));
+	auto length = unbuffered_length();
+
+	// pending writes may extend the stream
+	if (m_write_length > 0 && m_origin + m_write_length > length)
+		length = m_origin + m_write_length;
+
+	return length;
 }
 
-size_t Stream::write_u32(u32 value, Endian endian)
+size_t BufferedStream::position() const
 {
-	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return write_data(&value, sizeof(u32));
+	if (m_write_length > 0)
+		return m_origin + m_write_length;
+	if (m_read_end != nullptr)
+		return m_origin + (size_t)(m_read_cursor - m_buffer.data());
+	return m_origin;
 }
 
-size_t Stream::write_u64(u64 value, Endian endian)
+size_t BufferedStream::seek(size_t seek_to)
 {
-	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return write_data(&value, sizeof(u64));
+	// seeking within the read buffer doesn't need to touch the underlying stream
+	if (m_read_end != nullptr && seek_to >= m_origin && seek_to - m_origin <= (size_t)(m_read_end - m_buffer.data()))
+	{
+		m_read_cursor = m_buffer.data() + (seek_to - m_origin);
+		return seek_to;
+	}
+
+	flush();
+	m_read_cursor = m_read_end = nullptr;
+	return m_origin = unbuffered_seek(seek_to);
 }
 
-size_t Stream::write_i8(i8 value, Endian endian)
+bool BufferedStream::is_open() const
 {
-	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return write_data(&value, sizeof(i8));
+	return m_stream && m_stream->is_open();
 }
 
-size_t Stream::write_i16(i16 value, Endian endian)
+bool BufferedStream::is_readable() const
 {
-	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return write_data(&value, sizeof(i16));
+	return m_stream && m_stream->is_readable();
 }
 
-size_t Stream::write_i32(i32 value, Endian endian)
+bool BufferedStream::is_writable() const
 {
-	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return write_data(&value, sizeof(i32));
+	return m_stream && m_stream->is_writable();
 }
 
-size_t Stream::write_i64(i64 value, Endian endian)
+bool BufferedStream::flush()
 {
-	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return write_data(&value, sizeof(i64));
+	if (m_write_length <= 0)
+		return true;
+
+	auto wrote = unbuffered_write(m_buffer.data(), m_write_length);
+	auto success = (wrote == m_write_length);
+
+	m_origin += wrote;
+	m_write_length = 0;
+	return success;
 }
 
-size_t Stream::write_f32(float value, Endian endian)
+void BufferedStream::set_buffer_size(size_t buffer_size)
 {
-	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return write_data(&value, sizeof(float));
+	flush();
+	drop_read_buffer();
+	m_buffer.dispose();
+	m_buffer_size = buffer_size;
 }
 
-size_t Stream::write_f64(double value, Endian endian)
+size_t BufferedStream::buffer_size() const
 {
-	if (!Calc::is_endian(endian)) Calc::swap_endian(&value);
-	return write_data(&value, sizeof(double));
+	return m_buffer_size;
+}
+
+size_t BufferedStream::read_data(void* ptr, size_t len)
+{
+	if (ptr == nullptr || len <= 0)
+		return 0;
+
+	if (!flush())
+		return 0;
+
+	auto dst = (u8*)ptr;
+	size_t result = 0;
+
+	// use whatever is left in the buffer
+	if (m_read_end != nullptr)
+	{
+		result = Calc::min(len, (size_t)(m_read_end - m_read_cursor));
+		memcpy(dst, m_read_cursor, result);
+		m_read_cursor += result;
+	}
+
+	while (result < len)
+	{
+		// the underlying stream is now at the end of the buffer
+		if (m_read_end != nullptr)
+		{
+			m_origin += (size_t)(m_read_end - m_buffer.data());
+			m_read_cursor = m_read_end = nullptr;
+		}
+
+		auto remaining = len - result;
+
+		// large reads skip the buffer and go straight to the destination
+		if (remaining >= m_buffer_size || !alloc_buffer())
+		{
+			auto count = unbuffered_read(dst + result, remaining);
+			m_origin += count;
+			result += count;
+			break;
+		}
+
+		auto count = unbuffered_read(m_buffer.data(), m_buffer_size);
+		if (count <= 0)
+			break;
+
+		m_read_cursor = m_buffer.data();
+		m_read_end = m_buffer.data() + count;
+
+		auto step = Calc::min(remaining, count);
+		memcpy(dst + result, m_read_cursor, step);
+		m_read_cursor += step;
+		result += step;
+	}
+
+	return result;
+}
+
+size_t BufferedStream::write_data(const void* ptr, size_t len)
+{
+	if (ptr == nullptr || len <= 0)
+		return 0;
+
+	// the underlying stream has read ahead, so move it back to where we are
+	drop_read_buffer();
+
+	if (len > m_buffer_size - m_write_length && !flush())
+		return 0;
+
+	// large writes skip the buffer
+	if (len >= m_buffer_size || !alloc_buffer())
+	{
+		auto wrote = unbuffered_write(ptr, len);
+		m_origin += wrote;
+		return wrote;
+	}
+
+	memcpy(m_buffer.data() + m_write_length, ptr, len);
+	m_write_length += len;
+	return len;
+}
+
+size_t BufferedStream::unbuffered_length() const
+{
+	return (m_stream ? m_stream->length() : 0);
+}
+
+size_t BufferedStream::unbuffered_seek(size_t seek_to)
+{
+	return (m_stream ? m_stream->seek(seek_to) : 0);
+}
+
+size_t BufferedStream::unbuffered_read(void* ptr, size_t len)
+{
+	return (m_stream ? m_stream->read(ptr, len) : 0);
+}
+
+size_t BufferedStream::unbuffered_write(const void* ptr, size_t len)
+{
+	return (m_stream ? m_stream->write(ptr, len) : 0);
+}
+
+bool BufferedStream::alloc_buffer()
+{
+	if (m_buffer.size() < (i64)m_buffer_size)
+	{
+		Memory::TagScope tag(Memory::Tag::Stream);
+		m_buffer.resize((i64)m_buffer_size);
+	}
+
+	return m_buffer.size() >= (i64)m_buffer_size;
+}
+
+void BufferedStream::drop_read_buffer()
+{
+	if (m_read_end != nullptr)
+	{
+		auto pos = position();
+		auto ahead = (m_read_cursor != m_read_end);
+
+		m_read_cursor = m_read_end = nullptr;
+		m_origin = (ahead ? unbuffered_seek(pos) : pos);
+	}
 }
 
 
 // File Stream Implementation
 
-FileStream::FileStream(const FilePath& path, FileMode mode)
-	: m_file(File::open(path, mode)) {}
+FileStream::FileStream(const FilePath& path, FileMode mode, size_t buffer_size)
+	: m_file(File::open(path, mode))
+{
+	set_buffer_size(buffer_size);
+}
 
-FileStream::FileStream(const FileRef& file)
-	: m_file(file) {}
+FileStream::FileStream(const FileRef& file, size_t buffer_size)
+	: m_file(file)
+{
+	set_buffer_size(buffer_size);
 
-size_t FileStream::length() const
+	// start from wherever the File currently is
+	if (m_file)
+		seek(m_file->position());
+}
+
+FileStream::~FileStream()
 {
-	return (m_file ? m_file->length() : 0);
+	// flushed here, as the File is released before BufferedStream's destructor runs
+	flush();
 }
 
-size_t FileStream::position() const
+size_t FileStream::unbuffered_length() const
 {
-	return (m_file ? m_file->position() : 0);
+	return (m_file ? m_file->length() : 0);
 }
 
-size_t FileStream::seek(size_t seek_to)
+size_t FileStream::unbuffered_seek(size_t seek_to)
 {
 	return (m_file ? m_file->seek(seek_to) : 0);
 }
 
-size_t FileStream::read_data(void* ptr, size_t length)
+size_t FileStream::unbuffered_read(void* ptr, size_t length)
 {
 	return (m_file ? m_file->read(ptr, length) : 0);
 }
 
-size_t FileStream::write_data(const void* ptr, size_t length)
+size_t FileStream::unbuffered_write(const void* ptr, size_t length)
 {
 	return (m_file ? m_file->write(ptr, length) : 0);
 }
@@ -255,6 +405,92 @@ bool FileStream::is_writable() const
 }
 
 
+// Mapped File Stream Implementation
+
+MappedFileStream::MappedFileStream(const FilePath& path)
+{
+	size_t length = 0;
+
+	if (auto mapped = Platform::file_map(path.cstr(), &length))
+	{
+		m_data = (const u8*)mapped;
+		m_length = length;
+		m_mapped = true;
+		m_open = true;
+	}
+	// the file couldn't be mapped (or is empty), so read it into memory instead
+	else if (auto file = File::open(path, FileMode::OpenRead))
+	{
+		length = file->length();
+		if (length > (size_t)Vector<u8>::max_capacity)
+		{
+			Log::error("Unable to read '%s' as it is too large", path.cstr());
+			return;
+		}
+
+		Memory::TagScope tag(Memory::Tag::Stream);
+		if (auto buffer = m_buffer.expand_uninitialized((i64)length))
+			m_buffer.resize((i64)file->read(buffer, length));
+
+		m_data = m_buffer.data();
+		m_length = (size_t)m_buffer.size();
+		m_open = true;
+	}
+
+	// the whole file is the read window, so every read is a plain copy
+	m_read_cursor = m_data;
+	m_read_end = m_data + m_length;
+}
+
+MappedFileStream::~MappedFileStream()
+{
+	if (m_mapped)
+		Platform::file_unmap((void*)m_data, m_length);
+}
+
+size_t MappedFileStream::length() const
+{
+	return m_length;
+}
+
+size_t MappedFileStream::position() const
+{
+	return (size_t)(m_read_cursor - m_data);
+}
+
+size_t MappedFileStream::seek(size_t seek_to)
+{
+	if (seek_to > m_length)
+		seek_to = m_length;
+
+	m_read_cursor = m_data + seek_to;
+	return seek_to;
+}
+
+size_t MappedFileStream::read_data(void* ptr, size_t len)
+{
+	// only called when reading past the end, so copy whatever is left
+	if (ptr == nullptr || len <= 0 || m_read_cursor >= m_read_end)
+		return 0;
+
+	len = (size_t)(m_read_end - m_read_cursor);
+	memcpy(ptr, m_read_cursor, len);
+	m_read_cursor = m_read_end;
+	return len;
+}
+
+size_t MappedFileStream::write_data(const void*, size_t)
+{
+	return 0;
+}
+
+bool MappedFileStream::is_open() const { return m_open; }
+bool MappedFileStream::is_readable() const { return m_open; }
+bool MappedFileStream::is_writable() const { return false; }
+const u8* MappedFileStream::data() const { return m_data; }
+bool MappedFileStream::is_mapped() const { return m_mapped; }
+
+
 // Memory Stream Implementation
 
 MemoryStream::MemoryStream(u8* data, size_t length)
@@ -315,14 +551,15 @@ const u8* MemoryStream::data() const { return (m_data ? m_data : m_const_data);
 
 // Buffer Stream Implementation
 
-BufferStream::BufferStream(int capacity)
+BufferStream::BufferStream(size_t length)
 {
-	m_buffer.resize(capacity);
+	Memory::TagScope tag(Memory::Tag::Stream);
+	m_buffer.resize((i64)length);
 }
 
 size_t BufferStream::length() const
 {
-	return m_buffer.size();
+	return (size_t)m_buffer.size();
 }
 
 size_t BufferStream::position() const
@@ -332,7 +569,7 @@ size_t BufferStream::position() const
 
 size_t BufferStream::seek(size_t seek_to)
 {
-	return m_position = (seek_to < 0 ? 0 : (seek_to > m_buffer.size() ? m_buffer.size() : seek_to));
+	return m_position = (seek_to > length() ? length() : seek_to);
 }
 
 size_t BufferStream::read_data(void* ptr, size_t len)
@@ -340,8 +577,8 @@ size_t BufferStream::read_data(void* ptr, size_t len)
 	if (ptr == nullptr || len <= 0)
 		return 0;
 
-	if (len > m_buffer.size() - m_position)
-		len = m_buffer.size() - m_position;
+	if (len > length() - m_position)
+		len = length() - m_position;
 
 	memcpy(ptr, m_buffer.data() + m_position, (size_t)len);
 	m_position += len;
@@ -354,9 +591,18 @@ size_t BufferStream::write_data(const void* ptr, size_t len)
 		return 0;
 
 	// resize
-	if (m_position + len > m_buffer.size())
+	if (len > length() - m_position)
+	{
+		if (len > (size_t)Vector<u8>::max_capacity - m_position)
+			return 0;
+
 		resize(m_position + len);
 
+		// the buffer couldn't be grown
+		if (len > length() - m_position)
+			return 0;
+	}
+
 	// copy data
 	if (ptr != nullptr)
 		memcpy(m_buffer.data() + m_position, ptr, (size_t)len);
@@ -374,7 +620,8 @@ bool BufferStream::is_writable() const { return true; }
 
 void BufferStream::resize(size_t length)
 {
-	m_buffer.resize(length);
+	Memory::TagScope tag(Memory::Tag::Stream);
+	m_buffer.resize((i64)length);
 }
 
 void BufferStream::clear()
@@ -1,4 +1,5 @@
 #include <blah_string.h>
+#include <string.h> // for memcmp, strcmp
 
 using namespace Blah;
 
@@ -252,10 +253,55 @@ int BaseString::last_index_of(char ch) const
 
 bool BaseString::equals(const char* other, bool ignore_case) const
 {
+	if (other == nullptr)
+		other = "";
+
+	if (!ignore_case)
+		return strcmp(s_ptr(), other) == 0;
+
 	const char* a = s_ptr(); const char* b = other;
-	auto compare = (ignore_case ? &blah_compare_ignore_case : &blah_compare_with_case);
-	while ((*compare)(*a, *b) && *a != '\0') { a++; b++; }
-	return (*compare)(*a, *b);
+	while (blah_compare_ignore_case(*a, *b) && *a != '\0') { a++; b++; }
+	return blah_compare_ignore_case(*a, *b);
+}
+
+bool BaseString::equals(const BaseString& other) const
+{
+	// the lengths are known, so the characters can be compared in bulk
+	int len = s_len();
+	return len == other.s_len() && memcmp(s_ptr(), other.s_ptr(), len) == 0;
+}
+
+u32 BaseString::hash(const char* cstr, int length)
+{
+	constexpr u64 prime0 = 0x9e3779b97f4a7c15ULL;
+	constexpr u64 prime1 = 0xbf58476d1ce4e5b9ULL;
+
+	const u8* ptr = (const u8*)cstr;
+	u64 result = prime0 ^ (u64)length;
+
+	// hash a word at a time, rather than a byte at a time
+	while (length >= 8)
+	{
+		u64 word;
+		memcpy(&word, ptr, 8);
+		result = (result ^ word) * prime1;
+		result ^= result >> 29;
+		ptr += 8;
+		length -= 8;
+	}
+
+	if (length > 0)
+	{
+		u64 word = 0;
+		memcpy(&word, ptr, length);
+		result = (result ^ word) * prime1;
+		result ^= result >> 29;
+	}
+
+	result ^= result >> 32;
+	result *= prime0;
+	result ^= result >> 29;
+	return (u32)result;
 }
 
 namespace
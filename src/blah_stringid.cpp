@@ -0,0 +1,154 @@
+#include <blah_stringid.h>
+#include <blah_memory.h>
+#include <string.h> // for memcpy, strcmp
+
+#ifndef BLAH_NO_THREADING
+#include <mutex>
+#endif
+
+using namespace Blah;
+
+namespace
+{
+	// interned strings are allocated out of large blocks, and never freed
+	constexpr size_t block_size = 64 * 1024;
+
+	struct InternTable
+	{
+		u8* block = nullptr;
+		size_t block_used = 0;
+
+		// open-addressing table of interned entries
+		Vector<const void*> slots;
+		int count = 0;
+
+#ifndef BLAH_NO_THREADING
+		std::mutex mutex;
+#endif
+	};
+
+	// StringIds may be created during static initialization, so the table is created on first use
+	InternTable& blah_intern_table()
+	{
+		static InternTable table;
+		return table;
+	}
+
+	void* blah_intern_alloc(InternTable& table, size_t size)
+	{
+		size = (size + alignof(void*) - 1) & ~(alignof(void*) - 1);
+
+		if (table.block == nullptr || table.block_used + size > block_size)
+		{
+			// very long strings get their own allocation
+			if (size > block_size / 4)
+				return Memory::alloc(size, alignof(void*), Memory::Tag::String);
+
+			table.block = (u8*)Memory::alloc(block_size, alignof(void*), Memory::Tag::String);
+			table.block_used = 0;
+		}
+
+		void* result = table.block + table.block_used;
+		table.block_used += size;
+		return result;
+	}
+
+	// matches BaseString::hash("", 0), but is computed at compile time so the
+	// empty entry is ready before any static StringIds are constructed
+	constexpr u32 blah_empty_hash()
+	{
+		u64 result = 0x9e3779b97f4a7c15ULL;
+		result ^= result >> 32;
+		result *= 0x9e3779b97f4a7c15ULL;
+		result ^= result >> 29;
+		return (u32)result;
+	}
+}
+
+const StringId::Entry StringId::s_empty = { "", 0, blah_empty_hash() };
+
+StringId::StringId(const char* cstr)
+{
+	if (cstr != nullptr && cstr[0] != '\0')
+		m_entry = intern(cstr, (int)strlen(cstr));
+}
+
+StringId::StringId(const char* cstr, const char* cstr_end)
+{
+	if (cstr != nullptr && cstr_end > cstr)
+		m_entry = intern(cstr, (int)(cstr_end - cstr));
+}
+
+StringId::StringId(const BaseString& str)
+{
+	if (str.length() > 0)
+		m_entry = intern(str.cstr(), str.length());
+}
+
+bool StringId::operator==(const char* rhs) const
+{
+	return strcmp(cstr(), rhs ? rhs : "") == 0;
+}
+
+int StringId::interned_count()
+{
+	auto& table = blah_intern_table();
+
+#ifndef BLAH_NO_THREADING
+	std::lock_guard<std::mutex> lock(table.mutex);
+#endif
+	return table.count;
+}
+
+const StringId::Entry* StringId::intern(const char* cstr, int length)
+{
+	u32 hash = BaseString::hash(cstr, length);
+	auto& table = blah_intern_table();
+
+#ifndef BLAH_NO_THREADING
+	std::lock_guard<std::mutex> lock(table.mutex);
+#endif
+
+	// keep the table at most half full
+	if ((table.count + 1) * 2 > table.slots.size())
+	{
+		Vector<const void*> prev = std::move(table.slots);
+		table.slots.resize(prev.size() > 0 ? prev.size() * 2 : 256);
+
+		u32 mask = (u32)table.slots.size() - 1;
+		for (auto it : prev)
+		{
+			if (it == nullptr)
+				continue;
+
+			u32 slot = ((const Entry*)it)->hash & mask;
+			while (table.slots[slot] != nullptr)
+				slot = (slot + 1) & mask;
+			table.slots[slot] = it;
+		}
+	}
+
+	u32 mask = (u32)table.slots.size() - 1;
+	u32 slot = hash & mask;
+
+	while (auto it = (const Entry*)table.slots[slot])
+	{
+		if (it->hash == hash && it->length == length && memcmp(it->str, cstr, length) == 0)
+			return it;
+		slot = (slot + 1) & mask;
+	}
+
+	// add a new entry, with its characters stored right after it
+	auto entry = (Entry*)blah_intern_alloc(table, sizeof(Entry) + length + 1);
+	auto str = (char*)(entry + 1);
+	memcpy(str, cstr, length);
+	str[length] = '\0';
+
+	entry->str = str;
+	entry->length = length;
+	entry->hash = hash;
+
+	table.slots[slot] = entry;
+	table.count++;
+	return entry;
+}
@@ -0,0 +1,176 @@
+#include <blah_textlayout.h>
+
+using namespace Blah;
+
+namespace
+{
+	struct LineRange
+	{
+		int start;
+		int end;
+		float width;
+	};
+}
+
+TextLayout::TextLayout(const SpriteFont& font, const String& text)
+{
+	build(font, text);
+}
+
+TextLayout::TextLayout(const SpriteFont& font, const String& text, const Vec2f& justify, float max_width)
+{
+	build(font, text, justify, max_width);
+}
+
+void TextLayout::build(const SpriteFont& font, const String& text, const Vec2f& justify, float max_width)
+{
+	clear();
+	sdf_spread = font.sdf_spread();
+
+	if (text.length() <= 0)
+		return;
+
+	// decode the text once
+	Vector<SpriteFont::Codepoint> codepoints;
+	codepoints.reserve(text.length());
+
+	Utf8 utf8(text.cstr());
+	while (utf8.character)
+	{
+		codepoints.push_back(utf8.character);
+		utf8.next();
+	}
+
+	// find where each line starts & ends
+	Vector<LineRange> ranges;
+	int start = 0;
+
+	while (true)
+	{
+		float x = 0;
+		int end = start;
+		int next = -1;
+		SpriteFont::Codepoint last = 0;
+
+		// the last place the line can be wrapped (at a run of spaces)
+		int wrap_end = -1;
+		int wrap_next = -1;
+		float wrap_width = 0;
+
+		while (end < codepoints.size() && codepoints[end] != '\n')
+		{
+			auto codepoint = codepoints[end];
+
+			float advance = font[codepoint].advance;
+			if (last)
+				advance += font.get_kerning(last, codepoint);
+
+			if (max_width > 0 && end > start && codepoint != ' ' && x + advance > max_width)
+			{
+				if (wrap_end > start)
+				{
+					ranges.push_back({ start, wrap_end, wrap_width });
+					next = wrap_next;
+				}
+				else
+				{
+					ranges.push_back({ start, end, x });
+					next = end;
+				}
+				break;
+			}
+
+			if (codepoint == ' ')
+			{
+				if (last != ' ')
+				{
+					wrap_end = end;
+					wrap_width = x;
+				}
+				wrap_next = end + 1;
+			}
+
+			x += advance;
+			last = codepoint;
+			end++;
+		}
+
+		if (next >= 0)
+		{
+			start = next;
+			continue;
+		}
+
+		ranges.push_back({ start, end, x });
+
+		if (end >= codepoints.size())
+			break;
+
+		// skip the newline
+		start = end + 1;
+	}
+
+	// position every glyph
+	float line_height = font.line_height();
+	float height = ranges.size() * line_height - font.line_gap;
+	float top = -height * justify.y;
+	float left = 0;
+	float right = 0;
+
+	lines.reserve(ranges.size());
+	glyphs.reserve(codepoints.size());
+
+	for (int i = 0; i < ranges.size(); i++)
+	{
+		auto& range = ranges[i];
+
+		Vec2f offset = Vec2f(-range.width * justify.x, top + i * line_height);
+
+		Line line;
+		line.glyph_start = glyphs.size();
+		line.bounds = Rectf(offset.x, offset.y, range.width, font.height());
+
+		if (i == 0 || line.bounds.x < left)
+			left = line.bounds.x;
+		if (i == 0 || line.bounds.x + line.bounds.w > right)
+			right = line.bounds.x + line.bounds.w;
+
+		offset.y += font.ascent + font.descent;
+
+		SpriteFont::Codepoint last = 0;
+		for (int n = range.start; n < range.end; n++)
+		{
+			auto codepoint = codepoints[n];
+
+			if (last)
+				offset.x += font.get_kerning(last, codepoint);
+
+			const auto& ch = font[codepoint];
+			if (ch.subtexture.texture)
+			{
+				Glyph glyph;
+				glyph.codepoint = codepoint;
+				glyph.subtexture = ch.subtexture;
+				glyph.position = offset + ch.offset;
+				glyph.line = i;
+				glyphs.push_back(std::move(glyph));
+			}
+
+			offset.x += ch.advance;
+			last = codepoint;
+		}
+
+		line.glyph_count = glyphs.size() - line.glyph_start;
+		lines.push_back(line);
+	}
+
+	bounds = Rectf(left, top, right - left, height);
+}
+
+void TextLayout::clear()
+{
+	glyphs.clear();
+	lines.clear();
+	bounds = Rectf();
+	sdf_spread = 0;
+}
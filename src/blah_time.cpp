@@ -9,6 +9,7 @@ double Time::seconds = 0;
 double Time::previous_seconds = 0;
 float Time::delta = 0;
 float Time::pause_timer = 0;
+u64 Time::frames = 0;
 
 u64 Time::get_ticks()
 {
@@ -23,5 +23,10 @@ namespace Blah
 		bool audio_init(unsigned play_frequency_in_Hz, int buffered_samples);
 		void audio_shutdown();
 		void audio_update();
+
+		void file_update();
+		void file_shutdown();
+
+		void image_shutdown();
 	}
 }
\ No newline at end of file
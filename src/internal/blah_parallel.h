@@ -0,0 +1,66 @@
+#pragma once
+#include <blah_common.h>
+#include <blah_vector.h>
+
+#ifndef BLAH_NO_THREADING
+#include <thread>
+#include <atomic>
+#endif
+
+namespace Blah
+{
+	namespace Internal
+	{
+		// Gets the number of threads to use for the requested amount.
+		// Values <= 0 use every available hardware thread.
+		inline int thread_count(int requested)
+		{
+#ifndef BLAH_NO_THREADING
+			if (requested <= 0)
+				requested = (int)std::thread::hardware_concurrency();
+			return (requested > 0 ? requested : 1);
+#else
+			return 1;
+#endif
+		}
+
+		// Calls `fn(index)` for every index in [0, count), spread over up to `threads` threads.
+		// The calling thread also does work, and this returns once every index has been run.
+		// If threading is disabled (BLAH_NO_THREADING) everything is run on the calling thread.
+		template<class Fn>
+		void parallel_for(int count, int threads, const Fn& fn)
+		{
+#ifndef BLAH_NO_THREADING
+			threads = thread_count(threads);
+			if (threads > count)
+				threads = count;
+
+			if (threads > 1)
+			{
+				std::atomic<int> next(0);
+
+				auto work = [&]()
+				{
+					int index;
+					while ((index = next++) < count)
+						fn(index);
+				};
+
+				Vector<std::thread> workers;
+				workers.reserve(threads - 1);
+				for (int i = 0; i < threads - 1; i++)
+					workers.emplace_back(work);
+
+				work();
+
+				for (auto& it : workers)
+					it.join();
+				return;
+			}
+#endif
+
+			for (int i = 0; i < count; i++)
+				fn(i);
+		}
+	}
+}
@@ -18,6 +18,11 @@
 #include <windows.h>    // for the following includes
 #include <shellapi.h>	// for ShellExecute for dir_explore
 #include <SDL_syswm.h>  // for SDL_SysWMinfo for D3D11
+#elif !defined(__EMSCRIPTEN__)
+#include <sys/mman.h>   // for mmap for file_map
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 // Macro defined by X11 conflicts with MouseButton enum
@@ -503,6 +508,76 @@ FileRef Platform::file_open(const char* path, FileMode mode)
 	return FileRef(new SDL2_File(ptr));
 }
 
+void* Platform::file_map(const char* path, size_t* length)
+{
+#if _WIN32
+	// paths are utf8, so they need to be converted for the wide-char api
+	int wide_length = MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0);
+	if (wide_length <= 0)
+		return nullptr;
+
+	Vector<wchar_t> wide_path;
+	wide_path.resize(wide_length);
+	MultiByteToWideChar(CP_UTF8, 0, path, -1, wide_path.data(), wide_length);
+
+	HANDLE file = CreateFileW(wide_path.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+	{
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	// the view keeps the mapping & file open, so the handles can be closed right away
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr)
+		return nullptr;
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (data == nullptr)
+		return nullptr;
+
+	*length = (size_t)size.QuadPart;
+	return data;
+#elif defined(__EMSCRIPTEN__)
+	return nullptr;
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0)
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	// the mapping stays valid after the file is closed
+	void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		return nullptr;
+
+	*length = (size_t)st.st_size;
+	return data;
+#endif
+}
+
+void Platform::file_unmap(void* data, size_t length)
+{
+#if _WIN32
+	UnmapViewOfFile(data);
+#elif !defined(__EMSCRIPTEN__)
+	munmap(data, length);
+#endif
+}
+
 bool Platform::file_exists(const char* path)
 {
 	return std::filesystem::is_regular_file(path);
@@ -67,6 +67,12 @@ namespace Blah
 		// Opens a file and sets the handle, or returns an empty handle if it fails
 		FileRef file_open(const char* path, FileMode mode);
 
+		// Memory-maps the file for reading and sets its length, or returns nullptr if it can't be mapped
+		void* file_map(const char* path, size_t* length);
+
+		// Unmaps a file mapped with file_map
+		void file_unmap(void* data, size_t length);
+
 		// Returns true if a file with the given path exists
 		bool file_exists(const char* path);
 
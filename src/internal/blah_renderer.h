@@ -15,6 +15,9 @@ namespace Blah
 		// Default Shader for the Batcher, should be created in init
 		ShaderRef default_batcher_shader;
 
+		// Signed distance field text Shader for the Batcher, should be created in init
+		ShaderRef sdf_batcher_shader;
+
 		virtual ~Renderer() = default;
 
 		// Initialize the Graphics
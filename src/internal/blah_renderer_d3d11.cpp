@@ -78,6 +78,74 @@ namespace Blah
 		}
 	};
 
+	// u_sdf is (distance scale, outline width, shadow softness, unused)
+	const char* d3d11_sdf_batch_shader = ""
+		"cbuffer constants : register(b0)\n"
+		"{\n"
+		"	row_major float4x4 u_matrix;\n"
+		"	float4 u_sdf;\n"
+		"	float4 u_outline_color;\n"
+		"	float4 u_shadow_color;\n"
+		"	float2 u_shadow_offset;\n"
+		"}\n"
+
+		"struct vs_in\n"
+		"{\n"
+		"	float2 position : POS;\n"
+		"	float2 texcoord : TEX;\n"
+		"	float4 color : COL;\n"
+		"	float4 mask : MASK;\n"
+		"};\n"
+
+		"struct vs_out\n"
+		"{\n"
+		"	float4 position : SV_POSITION;\n"
+		"	float2 texcoord : TEX;\n"
+		"	float4 color : COL;\n"
+		"};\n"
+
+		"Texture2D    u_texture : register(t0);\n"
+		"SamplerState u_texture_sampler : register(s0);\n"
+
+		"vs_out vs_main(vs_in input)\n"
+		"{\n"
+		"	vs_out output;\n"
+
+		"	output.position = mul(float4(input.position, 0.0f, 1.0f), u_matrix);\n"
+		"	output.texcoord = input.texcoord;\n"
+		"	output.color = input.color;\n"
+
+		"	return output;\n"
+		"}\n"
+
+		"float4 ps_main(vs_out input) : SV_TARGET\n"
+		"{\n"
+		"	float width, height;\n"
+		"	u_texture.GetDimensions(width, height);\n"
+		"	float dist = (u_texture.Sample(u_texture_sampler, input.texcoord).a - 0.50196f) * u_sdf.x;\n"
+		"	float aa = max(fwidth(dist), 0.0001f);\n"
+		"	float fill = saturate(dist / aa + 0.5f);\n"
+		"	float outline = saturate((dist + u_sdf.y) / aa + 0.5f);\n"
+		"	float2 shadow_tex = input.texcoord - u_shadow_offset / float2(width, height);\n"
+		"	float shadow_dist = (u_texture.Sample(u_texture_sampler, shadow_tex).a - 0.50196f) * u_sdf.x + u_sdf.y;\n"
+		"	float shadow = saturate(shadow_dist / max(u_sdf.z, aa) + 0.5f);\n"
+		"	float4 color = input.color * fill;\n"
+		"	color += u_outline_color * (outline * input.color.a) * (1.0f - color.a);\n"
+		"	color += u_shadow_color * (shadow * input.color.a) * (1.0f - color.a);\n"
+		"	return color;\n"
+		"}\n";
+
+	const ShaderData d3d11_sdf_batch_shader_data = {
+		d3d11_sdf_batch_shader,
+		d3d11_sdf_batch_shader,
+		{
+			{ "POS", 0 },
+			{ "TEX", 0 },
+			{ "COL", 0 },
+			{ "MASK", 0 },
+		}
+	};
+
 	class D3D11_Shader;
 
 	class Renderer_D3D11 : public Renderer
@@ -297,6 +365,29 @@ namespace Blah
 				0);
 		}
 
+		void set_data(const u8* data, const Recti& rect) override
+		{
+			BLAH_ASSERT(rect.x >= 0 && rect.y >= 0 && rect.x + rect.w <= m_width && rect.y + rect.h <= m_height, "Rectangle must be within the Texture bounds");
+
+			// bounds
+			D3D11_BOX box;
+			box.left = rect.x;
+			box.right = rect.x + rect.w;
+			box.top = rect.y;
+			box.bottom = rect.y + rect.h;
+			box.front = 0;
+			box.back = 1;
+
+			// set data
+			RENDERER->context->UpdateSubresource(
+				texture,
+				0,
+				&box,
+				data,
+				(m_size / m_height / m_width) * rect.w,
+				0);
+		}
+
 		void get_data(u8* data) override
 		{
 			HRESULT hr;
@@ -853,6 +944,7 @@ namespace Blah
 
 		// create default sprite batch shader
 		default_batcher_shader = Shader::create(d3d11_batch_shader_data);
+		sdf_batcher_shader = Shader::create(d3d11_sdf_batch_shader_data);
 
 		return true;
 	}
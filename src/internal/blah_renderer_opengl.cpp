@@ -255,6 +255,7 @@ typedef char             GLchar;
 	GL_FUNC(BindRenderbuffer, void, GLenum target, GLuint id) \
 	GL_FUNC(BindFramebuffer, void, GLenum target, GLuint id) \
 	GL_FUNC(TexImage2D, void, GLenum target, GLint level, GLenum internalFormat, GLint width, GLint height, GLint border, GLenum format, GLenum type, const void* data) \
+	GL_FUNC(TexSubImage2D, void, GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint width, GLint height, GLenum format, GLenum type, const void* data) \
 	GL_FUNC(FramebufferRenderbuffer, void, GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) \
 	GL_FUNC(FramebufferTexture2D, void, GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) \
 	GL_FUNC(TexParameteri, void, GLenum target, GLenum name, GLint param) \
@@ -389,6 +390,59 @@ namespace Blah
 		"}"
 	};
 
+	const ShaderData opengl_sdf_batch_shader_data = {
+		// vertex shader
+#ifdef __EMSCRIPTEN__
+		"#version 300 es\n"
+#else
+		"#version 330\n"
+#endif
+		"uniform mat4 u_matrix;\n"
+		"layout(location=0) in vec2 a_position;\n"
+		"layout(location=1) in vec2 a_tex;\n"
+		"layout(location=2) in vec4 a_color;\n"
+		"layout(location=3) in vec4 a_type;\n"
+		"out vec2 v_tex;\n"
+		"out vec4 v_col;\n"
+		"void main(void)\n"
+		"{\n"
+		"	gl_Position = u_matrix * vec4(a_position.xy, 0, 1);\n"
+		"	v_tex = a_tex;\n"
+		"	v_col = a_color;\n"
+		"}",
+
+		// fragment shader
+		// u_sdf is (distance scale, outline width, shadow softness, unused)
+#ifdef __EMSCRIPTEN__
+		"#version 300 es\n"
+		"precision mediump float;\n"
+#else
+		"#version 330\n"
+#endif
+		"uniform sampler2D u_texture;\n"
+		"uniform vec4 u_sdf;\n"
+		"uniform vec4 u_outline_color;\n"
+		"uniform vec4 u_shadow_color;\n"
+		"uniform vec2 u_shadow_offset;\n"
+		"in vec2 v_tex;\n"
+		"in vec4 v_col;\n"
+		"out vec4 o_color;\n"
+		"void main(void)\n"
+		"{\n"
+		"	float dist = (texture(u_texture, v_tex).a - 0.50196) * u_sdf.x;\n"
+		"	float aa = max(fwidth(dist), 0.0001);\n"
+		"	float fill = clamp(dist / aa + 0.5, 0.0, 1.0);\n"
+		"	float outline = clamp((dist + u_sdf.y) / aa + 0.5, 0.0, 1.0);\n"
+		"	vec2 shadow_tex = v_tex - u_shadow_offset / vec2(textureSize(u_texture, 0));\n"
+		"	float shadow_dist = (texture(u_texture, shadow_tex).a - 0.50196) * u_sdf.x + u_sdf.y;\n"
+		"	float shadow = clamp(shadow_dist / max(u_sdf.z, aa) + 0.5, 0.0, 1.0);\n"
+		"	vec4 color = v_col * fill;\n"
+		"	color += u_outline_color * (outline * v_col.a) * (1.0 - color.a);\n"
+		"	color += u_shadow_color * (shadow * v_col.a) * (1.0 - color.a);\n"
+		"	o_color = color;\n"
+		"}"
+	};
+
 	class Renderer_OpenGL : public Renderer
 	{
 	public:
@@ -716,6 +770,15 @@ namespace Blah
 			RENDERER->gl.TexImage2D(GL_TEXTURE_2D, 0, m_gl_internal_format, m_width, m_height, 0, m_gl_format, m_gl_type, data);
 		}
 
+		virtual void set_data(const u8* data, const Recti& rect) override
+		{
+			BLAH_ASSERT(rect.x >= 0 && rect.y >= 0 && rect.x + rect.w <= m_width && rect.y + rect.h <= m_height, "Rectangle must be within the Texture bounds");
+
+			RENDERER->gl.ActiveTexture(GL_TEXTURE0);
+			RENDERER->gl.BindTexture(GL_TEXTURE_2D, m_id);
+			RENDERER->gl.TexSubImage2D(GL_TEXTURE_2D, 0, rect.x, rect.y, rect.w, rect.h, m_gl_format, m_gl_type, data);
+		}
+
 		virtual void get_data(u8* data) override
 		{
 			RENDERER->gl.ActiveTexture(GL_TEXTURE0);
@@ -1223,6 +1286,7 @@ namespace Blah
 
 		// create the default batch shader
 		default_batcher_shader = Shader::create(opengl_batch_shader_data);
+		sdf_batcher_shader = Shader::create(opengl_sdf_batch_shader_data);
 
 		return true;
 	}